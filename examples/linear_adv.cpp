@@ -42,15 +42,17 @@ int main() {
     scalar_t u_ref = 1.0;
     scene.initial_condition = [&] (const arr_t<1>& x) {
         scalar_t rho = 2.0 + std::sin(2.0 * M_PI * x[0]);
-        return vec_t{rho, u_ref, 1.0};
+        return model_t::var_t{rho, u_ref, 1.0};
     };
 
     // ##################
 	// # RUN SIMULATION #
 	// ##################
-    integrator::Integrator<model_t, fSolver> integrator{mesh, scene, porder, cfl};
-    driver::Driver driver(EXAMPLE_NAME, integrator, tSolver{});
-    driver.run(write_interval, end_time);
+    integrator::dispatch_porder(porder, [&](auto Nnodes) {
+        integrator::Integrator<model_t, fSolver, decltype(Nnodes)::value> integrator{mesh, scene, porder, cfl};
+        driver::Driver driver(EXAMPLE_NAME, integrator, tSolver{});
+        driver.run(write_interval, end_time);
+    });
     
     return 0;
 }
\ No newline at end of file
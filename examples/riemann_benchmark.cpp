@@ -0,0 +1,202 @@
+// common lib headers
+#include <DG.hpp>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/timeSolver.hpp"
+
+// problem specific headers
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using var_t = model_t::var_t;
+
+/*
+    exact solution of the Riemann problem of the Euler equations (Toro, ch. 4), primitive
+    variables at x/t = xi
+*/
+struct ExactRiemann {
+    static constexpr scalar_t g = model_t::gamma;
+
+    var_t L, R;
+    scalar_t p_star, u_star;
+
+    // pressure function of one side and its derivative
+    static void f(scalar_t p, const var_t &W, scalar_t &F, scalar_t &dF) {
+        scalar_t c = std::sqrt(g * W[2] / W[0]);
+        if (p > W[2]) {
+            scalar_t A = 2.0 / ((g + 1) * W[0]);
+            scalar_t B = (g - 1) / (g + 1) * W[2];
+            F  = (p - W[2]) * std::sqrt(A / (p + B));
+            dF = std::sqrt(A / (p + B)) * (1.0 - 0.5 * (p - W[2]) / (p + B));
+        } else {
+            F  = 2.0 * c / (g - 1) * (std::pow(p / W[2], (g - 1) / (2 * g)) - 1.0);
+            dF = 1.0 / (W[0] * c) * std::pow(p / W[2], -(g + 1) / (2 * g));
+        }
+    }
+
+    ExactRiemann(const var_t &L, const var_t &R) : L(L), R(R) {
+        p_star = 0.5 * (L[2] + R[2]);
+        for (size_t k = 0; k < 50; k++) {
+            scalar_t FL, dFL, FR, dFR;
+            f(p_star, L, FL, dFL);
+            f(p_star, R, FR, dFR);
+            scalar_t dp = (FL + FR + R[1] - L[1]) / (dFL + dFR);
+            p_star = std::max(p_star - dp, 1e-12 * p_star);
+            if (std::abs(dp) < 1e-14 * p_star) break;
+        }
+        scalar_t FL, dFL, FR, dFR;
+        f(p_star, L, FL, dFL);
+        f(p_star, R, FR, dFR);
+        u_star = 0.5 * (L[1] + R[1]) + 0.5 * (FR - FL);
+    }
+
+    // one side, s = -1 for the left and +1 for the right state
+    var_t side(scalar_t xi, const var_t &W, scalar_t s) const {
+        scalar_t c = std::sqrt(g * W[2] / W[0]);
+        scalar_t r = p_star / W[2];
+        if (p_star > W[2]) {
+            // shock
+            scalar_t S = W[1] + s * c * std::sqrt((g + 1) / (2 * g) * r + (g - 1) / (2 * g));
+            if (s * (xi - S) >= 0.0) return W;
+            scalar_t rho = W[0] * (r + (g - 1) / (g + 1)) / ((g - 1) / (g + 1) * r + 1.0);
+            return var_t{rho, u_star, p_star};
+        }
+        // rarefaction
+        scalar_t c_star = c * std::pow(r, (g - 1) / (2 * g));
+        scalar_t head = W[1] + s * c;
+        scalar_t tail = u_star + s * c_star;
+        if (s * (xi - head) >= 0.0) return W;
+        if (s * (xi - tail) <= 0.0) return var_t{W[0] * std::pow(r, 1.0 / g), u_star, p_star};
+        scalar_t u = 2.0 / (g + 1) * (-s * c + (g - 1) / 2 * W[1] + xi);
+        scalar_t cf = 2.0 / (g + 1) * (c - s * (g - 1) / 2 * (W[1] - xi));
+        scalar_t rho = W[0] * std::pow(cf / c, 2.0 / (g - 1));
+        return var_t{rho, u, W[2] * std::pow(cf / c, 2 * g / (g - 1))};
+    }
+
+    var_t operator()(scalar_t xi) const {
+        return (xi < u_star) ? side(xi, L, -1.0) : side(xi, R, 1.0);
+    }
+};
+
+struct Result {
+    scalar_t seconds;
+    scalar_t error;         // L1 density error over the domain
+    scalar_t contact;       // L1 density error around the contact
+};
+
+/*
+    shock tube of `shock_tube` with the given flux, porder and mesh; the errors are integrated
+    with the quadrature of the cells
+*/
+template<typename fSolver>
+Result run(size_t porder, size_t mesh_size, const ExactRiemann &exact, scalar_t end_time) {
+    using tSolver = integrator::time::SSP_RK3;
+
+    mesh::Line mesh(mesh_size, 1.0);
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [&] (const arr_t<1>& x) {
+        return (x[0] < 0.5) ? exact.L : exact.R;
+    };
+    scene.boundary_conditions.resize(mesh.set_boundary());
+    scene.boundary_conditions[LEFT]  = [] () { return scene::Boundary<model_t>::Neumann(); };
+    scene.boundary_conditions[RIGHT] = [] () { return scene::Boundary<model_t>::Neumann(); };
+
+    Result result{};
+    integrator::dispatch_porder(porder, [&](auto Nnodes) {
+        integrator::Integrator<model_t, fSolver, decltype(Nnodes)::value> integrator{mesh, scene, porder, 0.5};
+        tSolver timeSolver;
+
+        auto start = std::chrono::steady_clock::now();
+        integrator.run_team([&](const execution::Team &team) {
+            scalar_t time = 0.0;
+            while (time < end_time) {
+                scalar_t dt = std::min(integrator.compute_dt_global(team), end_time - time);
+                timeSolver.advance(integrator, dt, team);
+                time += dt;
+            }
+        });
+        std::chrono::duration<scalar_t> elapsed = std::chrono::steady_clock::now() - start;
+        result.seconds = elapsed.count();
+
+        integrator.update_primitive();
+        const scalar_t x_contact = 0.5 + exact.u_star * end_time;
+        for (size_t i = 0; i < integrator.field.Ncells; i++) {
+            auto cell = integrator.cell(i);
+            for (size_t j = 0; j < integrator.field.Nnodes; j++) {
+                scalar_t x = cell.x[j][0];
+                scalar_t e = std::abs(cell.p(j, 0) - exact((x - 0.5) / end_time)[0]) * integrator.ref_cell.w[j] * integrator.field.detJ[i];
+                result.error += e;
+                if (std::abs(x - x_contact) < 0.05) result.contact += e;
+            }
+        }
+    });
+    return result;
+}
+
+/*
+    cost of the batched numerical flux alone, in ns per face
+*/
+template<typename fSolver>
+scalar_t flux_cost(const ExactRiemann &exact) {
+    constexpr size_t NE = model_t::NumEqns;
+    constexpr size_t P = integrator::VolumePacket;
+    constexpr size_t repeat = 20000;
+
+    std::vector<scalar_t> u_minus(NE * P), u_plus(NE * P), f(NE * P);
+    for (size_t i = 0; i < P; i++) {
+        scalar_t s = scalar_t(i) / P;
+        var_t um = model_t::PtoU(exact(-400.0 + 800.0 * s));
+        var_t up = model_t::PtoU(exact(-400.0 + 800.0 * (s + 0.5 / P)));
+        for (size_t k = 0; k < NE; k++) {
+            u_minus[k * P + i] = um[k];
+            u_plus[k * P + i] = up[k];
+        }
+    }
+
+    scalar_t checksum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeat; r++) {
+        fSolver::flux_batch(u_minus.data(), u_plus.data(), f.data(), P, P, 0);
+        checksum += f[r % (NE * P)];
+    }
+    std::chrono::duration<scalar_t> elapsed = std::chrono::steady_clock::now() - start;
+    if (!std::isfinite(checksum)) std::cout << "non-finite flux" << std::endl;
+    return elapsed.count() / (repeat * P) * 1e9;
+}
+
+template<typename fSolver>
+void benchmark(const std::string &name, const ExactRiemann &exact, scalar_t end_time, std::ofstream &file) {
+    std::cout << name << ": " << flux_cost<fSolver>(exact) << " ns per face" << std::endl;
+    // without a limiter, porder = 4 is the lowest order that is stable at this cfl
+    const size_t porder = 4;
+    for (size_t mesh_size : {25, 50, 100, 200, 400}) {
+        Result r = run<fSolver>(porder, mesh_size, exact, end_time);
+        std::cout << "  " << mesh_size << " cells: " << r.seconds << " s, L1 error = " << r.error
+                  << ", contact = " << r.contact << std::endl;
+        file << name << "," << porder << "," << mesh_size << "," << r.seconds << "," << r.error << "," << r.contact << "\n";
+    }
+}
+
+int main() {
+    // initial states of `shock_tube`, primitive variables
+    ExactRiemann exact(var_t{2.0, 0.0, 2.0e5}, var_t{1.0, 0.0, 1.0e5});
+    scalar_t end_time = 8e-4;
+
+    std::ofstream file(std::string(EXAMPLE_NAME) + ".csv");
+    file << "flux,porder,cells,seconds,error,contact_error" << std::endl;
+
+    benchmark<integrator::flux::LaxFriedrichs<model_t>>("LaxFriedrichs", exact, end_time, file);
+    benchmark<integrator::flux::HLLC<model_t>>("HLLC", exact, end_time, file);
+    benchmark<integrator::flux::Roe<model_t>>("Roe", exact, end_time, file);
+
+    return 0;
+}
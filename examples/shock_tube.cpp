@@ -41,9 +41,9 @@ int main() {
     // set up initial condition
     scene.initial_condition = [&] (const arr_t<1>& x) {
         if (x[0] < 0.5) 
-            return vec_t{2.0, 0.0, 2.0e5};
+            return model_t::var_t{2.0, 0.0, 2.0e5};
         else
-            return vec_t{1.0, 0.0, 1.0e5};
+            return model_t::var_t{1.0, 0.0, 1.0e5};
     };
 
     // set up boundary conditions
@@ -60,9 +60,12 @@ int main() {
     // ##################
 	// # RUN SIMULATION #
 	// ##################
-    integrator::Integrator<model_t, fSolver> integrator{mesh, scene, porder, cfl};
-    driver::Driver driver(EXAMPLE_NAME, integrator, tSolver{});
-    driver.run(write_interval, end_time);
+    integrator::dispatch_porder(porder, [&](auto Nnodes) {
+        using policy_t = execution::parallel_policy;     // execution::sequenced_policy for one thread
+        integrator::Integrator<model_t, fSolver, decltype(Nnodes)::value, policy_t> integrator{mesh, scene, porder, cfl, policy_t{.pin = true}};
+        driver::Driver driver(EXAMPLE_NAME, integrator, tSolver{});
+        driver.run(write_interval, end_time);
+    });
     
     return 0;
 }
\ No newline at end of file
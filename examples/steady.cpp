@@ -0,0 +1,69 @@
+// common lib headers
+#include <DG.hpp>
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/steadySolver.hpp"
+#include "driver/driver.hpp"
+
+// problem specific headers
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+int main() {
+    // ##################
+	// # MODEL, SOLVER  #
+	// ##################
+    using model_t = model::Euler<1>;
+    using fSolver = integrator::flux::LaxFriedrichs<model_t>; 
+
+    // ##################
+	// # NUMERICS       #
+	// ##################
+    size_t porder = 4;
+    size_t mesh_size = 50;
+    scalar_t domain_size = 1.0;
+    scalar_t cfl = 0.5;
+
+    size_t print_interval = 10;
+
+    mesh::Line mesh(mesh_size, domain_size);    // generate mesh
+    
+    // ##################
+	// # SCENE          #
+	// ##################
+    scene::Scene<model_t> scene;
+
+    // supersonic flow with a density and pressure bump that is washed out of the domain
+    scene.initial_condition = [&] (const arr_t<1>& x) {
+        scalar_t bump = std::exp(-100.0 * (x[0] - 0.5) * (x[0] - 0.5));
+        return model_t::var_t{1.0 + 0.2 * bump, 800.0, 1.0e5 * (1.0 + 0.2 * bump)};
+    };
+
+    // set up boundary conditions
+    scene.boundary_conditions.resize(mesh.set_boundary());
+
+    scene.boundary_conditions[LEFT] = [] () {
+        return scene::Boundary<model_t>::Dirichlet(model_t::PtoU({1.0, 800.0, 1.0e5}));
+    };
+
+    scene.boundary_conditions[RIGHT] = [] () {
+        return scene::Boundary<model_t>::Neumann();
+    };
+
+    // ##################
+	// # RUN SIMULATION #
+	// ##################
+    integrator::dispatch_porder(porder, [&](auto Nnodes) {
+        using policy_t = execution::parallel_policy;     // execution::sequenced_policy for one thread
+        using integrator_t = integrator::Integrator<model_t, fSolver, decltype(Nnodes)::value, policy_t>;
+        integrator_t integrator{mesh, scene, porder, cfl, policy_t{.pin = true}};
+        integrator::steady::PMultigrid<integrator_t> sSolver(integrator, mesh);
+        driver::Driver driver(EXAMPLE_NAME, integrator, sSolver);
+        driver.run_steady(print_interval);
+    });
+    
+    return 0;
+}
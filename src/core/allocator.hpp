@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace DG::core{
+    /* alignment of container storage: one cache line, also enough for AVX-512 loads */
+    inline constexpr size_t Alignment = 64;
+
+    /**
+     * @brief allocator returning cache line aligned storage
+     *
+     * used by `vec` so that field buffers start on a cache line and can be streamed with
+     * aligned vector loads
+     */
+    template<typename T, const size_t Align = Alignment>
+    struct aligned_allocator {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = aligned_allocator<U, Align>; };
+
+        aligned_allocator() = default;
+
+        template<typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+        }
+
+        void deallocate(T *p, size_t) {
+            ::operator delete(p, std::align_val_t(Align));
+        }
+
+        template<typename U>
+        bool operator==(const aligned_allocator<U, Align>&) const { return true; }
+    };
+}
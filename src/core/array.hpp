@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
 #include "vector.hpp"
@@ -31,6 +34,11 @@ namespace DG::core{
             }
         }
 
+        // size
+        static constexpr size_t size() {
+            return N;
+        }
+
         // element reference
         T& operator[](const size_t i) {
             return data_[i];
@@ -40,6 +48,9 @@ namespace DG::core{
             return data_[i];
         }
 
+        T* data() { return data_.data(); }
+        const T* data() const { return data_.data(); }
+
         // operators
         arr& operator=(const T& value) {
             for (size_t i = 0; i < N; i++) {
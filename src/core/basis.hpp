@@ -1,12 +1,16 @@
 #pragma once
 
 #include "core/quadrature.hpp"
+#include "core/tables.hpp"
 #include "types.hpp"
 #include <cstddef>
 
 namespace DG::core {
     /**
      *  @brief the reference cell 
+     *
+     *  For MinTableNodes <= n <= MaxTableNodes and the default node solver, x, w, D, Minv and
+     *  the lift vectors are copied from the compile-time `RefTable<n>`.
      */
     struct RefCell {
         size_t n;       // number of quadrature points
@@ -20,35 +24,78 @@ namespace DG::core {
         mat_t D;        // Differentiation matrix
         mat_t B;        // Boundary matrix
         mat_t MinvB;    // Inverse of mass matrix times the boundary matrix
+        vec_t lift_L;   // Lift vectors: the nonzero first and last columns of MinvB
+        vec_t lift_R;
 
         // constructor: compute all matrices
-        RefCell(size_t n) : n(n), x(n), w(n), V(n, n), dV(n, n), M(n, n), Minv(n, n), D(n, n), B(n, n), MinvB(n, n)
+        RefCell(size_t n, NodeSolver solver = NodeSolver::Auto) : n(n), x(n), w(n), V(n, n), dV(n, n), M(n, n), Minv(n, n), D(n, n), B(n, n), MinvB(n, n), lift_L(n), lift_R(n)
         {
-            // quadrature. TODO: could template over quadrature type
-            Lobatto Q(n);
-            x = Q.x; w = Q.w;
+            bool tabulated = (solver == NodeSolver::Auto) && load_table(n);
+
+            if (!tabulated) {
+                // quadrature. TODO: could template over quadrature type
+                Lobatto Q(n, solver);
+                x = Q.x; w = Q.w;
+            }
 
             // Vandermonde matrix
+            mat_t P, dP;
+            Legendre::table(x, n - 1, P, dP);
             for (size_t i = 0; i < n; i++) {
                 for (size_t j = 0; j < n; j++) {
-                    V(i, j)  = std::sqrt(0.5*(2.0*j + 1.0)) * Legendre::poly(x[i], j);
-                    dV(i, j) = std::sqrt(0.5*(2.0*j + 1.0)) * Legendre::d_poly(x[i], j);
+                    V(i, j)  = std::sqrt(0.5*(2.0*j + 1.0)) * P(i, j);
+                    dV(i, j) = std::sqrt(0.5*(2.0*j + 1.0)) * dP(i, j);
                 }
             }
 
-            // Mass matrix
-            Minv = V * V.transpose();
-            M = Minv.inv();
+            // Mass matrix, Minv is symmetric positive definite
+            if (!tabulated) Minv = V * V.transpose();
+            M = Minv.cholesky().solve(Minv.identity());
 
-            // Differentiation matrix
-            D = dV * V.inv();
+            // Differentiation matrix: D V = dV, solved as V^T D^T = dV^T
+            if (!tabulated) D = V.transpose().lu().solve(dV.transpose()).transpose();
 
             // Boundary matrix
             B = 0.0;
             B(0, 0) = -1.0; 
             B(n-1, n-1) = 1.0;
 
-            MinvB = Minv * B;
+            if (!tabulated) {
+                MinvB = Minv * B;
+                for (size_t i = 0; i < n; i++) {
+                    lift_L[i] = MinvB(i, 0);
+                    lift_R[i] = MinvB(i, n-1);
+                }
+            } else {
+                MinvB = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    MinvB(i, 0)   = lift_L[i];
+                    MinvB(i, n-1) = lift_R[i];
+                }
+            }
+        }
+
+        // copy the compile-time operators, returns false if n is not tabulated
+        template<size_t N = MinTableNodes>
+        bool load_table(size_t n) {
+            if constexpr (N > MaxTableNodes) {
+                return false;
+            } else {
+                if (n != N) return load_table<N + 1>(n);
+
+                constexpr const RefTable<N> &T = ref_table<N>;
+                for (size_t i = 0; i < N; i++) {
+                    x[i] = T.x[i];
+                    w[i] = T.w[i];
+                    lift_L[i] = T.lift_L[i];
+                    lift_R[i] = T.lift_R[i];
+                    for (size_t j = 0; j < N; j++) {
+                        D(i, j)    = T.D[i * N + j];
+                        Minv(i, j) = T.Minv[i * N + j];
+                    }
+                }
+                return true;
+            }
         }
 
         ~RefCell() = default;
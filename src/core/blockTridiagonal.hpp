@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <vector>
+#include "matrix.hpp"
+#include "parallel.hpp"
+
+namespace DG::core {
+    /**
+     * @brief block tridiagonal matrix, optionally with cyclic corner blocks
+     *
+     * Block row i reads lower[i] x[i-1] + diag[i] x[i] + upper[i] x[i+1], all blocks are b x b.
+     * For a periodic matrix lower[0] couples x[N-1] and upper[N-1] couples x[0]; otherwise the
+     * two corner blocks are ignored.
+     *
+     * `factorize` overwrites the blocks with the factors, so the matrix has to be assembled
+     * again before the next factorization; `solve` can be called any number of times after it.
+     * Two algorithms are available:
+     *  - Thomas: block LU without pivoting between blocks, run by the first thread of a team.
+     *  - CyclicReduction: odd-even reduction, every level eliminates the odd block rows in
+     *    parallel, about twice the flops of Thomas in log2(N) steps separated by barriers.
+     * The operations on a block row do not depend on the number of threads, so both give the
+     * same bits for any team. The corner blocks of a periodic matrix are a rank 2b update of
+     * the tridiagonal part and are handled with the Sherman-Morrison-Woodbury formula.
+     */
+    template<typename T>
+    class BlockTridiagonal {
+    private:
+
+        size_t N = 0;       // block rows
+        size_t b = 0;       // block size
+        bool periodic_ = false;
+
+        std::vector<std::optional<LU<T>>> lu;   // factors of the (reduced) diagonal blocks
+        std::vector<std::vector<matrix<T>>> Lk, Uk;    // cyclic reduction: couplings of the even rows per level
+
+        // periodic: corner blocks, Z = T^-1 [e_0, e_N-1] and the capacitance matrix
+        matrix<T> E_first, E_last;
+        std::vector<matrix<T>> Z;
+        std::optional<LU<T>> capacitance;
+        matrix<T> s;
+
+        std::vector<matrix<T>> y;   // right hand side blocks of `solve`
+
+        // even rows of the cyclic reduction level with stride s, i = 2 s k
+        size_t even_rows(size_t stride) const { return (N + 2 * stride - 1) / (2 * stride); }
+        // odd rows, i = s + 2 s k
+        size_t odd_rows(size_t stride) const { return (N - stride + 2 * stride - 1) / (2 * stride); }
+
+        void factorize_thomas() {
+            for (size_t i = 0; i < N; i++) {
+                if (i > 0) diag[i] -= lower[i] * upper[i - 1];
+                lu[i].emplace(diag[i]);
+                if (i + 1 < N) lu[i]->solve_in_place(upper[i]);    // upper[i] = diag[i]^-1 upper[i]
+            }
+        }
+
+        void solve_thomas(std::vector<matrix<T>> &x) const {
+            for (size_t i = 0; i < N; i++) {
+                if (i > 0) x[i] -= lower[i] * x[i - 1];
+                lu[i]->solve_in_place(x[i]);
+            }
+            for (size_t i = N - 1; i-- > 0;) {
+                x[i] -= upper[i] * x[i + 1];
+            }
+        }
+
+        void factorize_cyclic_reduction(const execution::Team &team) {
+            if (team.rank == 0) {
+                Lk.clear();
+                Uk.clear();
+                for (size_t s = 1; s < N; s *= 2) {
+                    Lk.emplace_back(even_rows(s));
+                    Uk.emplace_back(even_rows(s));
+                }
+            }
+            team.sync();
+
+            size_t level = 0;
+            for (size_t s = 1; s < N; s *= 2, level++) {
+                // odd rows: factorize, lower and upper become diag^-1 lower and diag^-1 upper
+                auto [ob, oe] = team.chunk(odd_rows(s));
+                for (size_t k = ob; k < oe; k++) {
+                    const size_t m = s + 2 * s * k;
+                    lu[m].emplace(diag[m]);
+                    lu[m]->solve_in_place(lower[m]);
+                    if (m + s < N) {
+                        lu[m]->solve_in_place(upper[m]);
+                    } else {
+                        upper[m] = T(0);
+                    }
+                }
+                team.sync();
+
+                // even rows: eliminate the odd neighbours at distance s
+                auto [eb, ee] = team.chunk(even_rows(s));
+                for (size_t k = eb; k < ee; k++) {
+                    const size_t i = 2 * s * k;
+                    Lk[level][k] = lower[i];
+                    Uk[level][k] = upper[i];
+                    if (i >= s) {
+                        diag[i] -= Lk[level][k] * upper[i - s];
+                        lower[i] = Lk[level][k] * lower[i - s] * T(-1);
+                    } else {
+                        lower[i] = T(0);
+                    }
+                    if (i + s < N) {
+                        diag[i] -= Uk[level][k] * lower[i + s];
+                        upper[i] = Uk[level][k] * upper[i + s] * T(-1);
+                    } else {
+                        upper[i] = T(0);
+                    }
+                }
+                team.sync();
+            }
+
+            if (team.rank == 0) lu[0].emplace(diag[0]);
+            team.sync();
+        }
+
+        void solve_cyclic_reduction(const execution::Team &team, std::vector<matrix<T>> &x) const {
+            const size_t levels = Lk.size();
+
+            // reduction of the right hand side
+            for (size_t level = 0, s = 1; level < levels; level++, s *= 2) {
+                auto [eb, ee] = team.chunk(even_rows(s));
+                for (size_t k = eb; k < ee; k++) {
+                    const size_t i = 2 * s * k;
+                    if (i >= s)    x[i] -= Lk[level][k] * lu[i - s]->solve(x[i - s]);
+                    if (i + s < N) x[i] -= Uk[level][k] * lu[i + s]->solve(x[i + s]);
+                }
+                team.sync();
+            }
+
+            if (team.rank == 0) lu[0]->solve_in_place(x[0]);
+            team.sync();
+
+            // back substitution of the odd rows, coarsest level first
+            for (size_t level = levels; level-- > 0;) {
+                const size_t s = size_t(1) << level;
+                auto [ob, oe] = team.chunk(odd_rows(s));
+                for (size_t k = ob; k < oe; k++) {
+                    const size_t m = s + 2 * s * k;
+                    lu[m]->solve_in_place(x[m]);
+                    x[m] -= lower[m] * x[m - s];
+                    if (m + s < N) x[m] -= upper[m] * x[m + s];
+                }
+                team.sync();
+            }
+        }
+
+        // factorization of the tridiagonal part
+        void factorize_tridiagonal(const execution::Team &team) {
+            if (algorithm == Algorithm::CyclicReduction) {
+                factorize_cyclic_reduction(team);
+                return;
+            }
+            if (team.rank == 0) factorize_thomas();
+            team.sync();
+        }
+
+        // x = T^-1 x for the tridiagonal part T
+        void solve_tridiagonal(const execution::Team &team, std::vector<matrix<T>> &x) const {
+            if (algorithm == Algorithm::CyclicReduction) {
+                solve_cyclic_reduction(team, x);
+                return;
+            }
+            if (team.rank == 0) solve_thomas(x);
+            team.sync();
+        }
+
+    public:
+        enum class Algorithm {
+            Thomas,
+            CyclicReduction
+        };
+
+        Algorithm algorithm = Algorithm::Thomas;
+
+        std::vector<matrix<T>> lower, diag, upper;
+
+        BlockTridiagonal() = default;
+
+        BlockTridiagonal(size_t N, size_t b, bool periodic = false) {
+            resize(N, b, periodic);
+        }
+
+        // N block rows of zero b x b blocks
+        void resize(size_t N, size_t b, bool periodic = false) {
+            this->N = N;
+            this->b = b;
+            periodic_ = periodic;
+            lower.assign(N, matrix<T>(b, b));
+            diag.assign(N, matrix<T>(b, b));
+            upper.assign(N, matrix<T>(b, b));
+            lu.assign(N, std::nullopt);
+            Z.assign(periodic ? N : 0, matrix<T>());
+            zero();
+        }
+
+        void zero() {
+            for (size_t i = 0; i < N; i++) {
+                lower[i] = T(0);
+                diag[i] = T(0);
+                upper[i] = T(0);
+            }
+        }
+
+        size_t blocks() const { return N; }
+        size_t block_size() const { return b; }
+        size_t size() const { return N * b; }
+        bool periodic() const { return periodic_; }
+
+        /*
+            factorization by all threads of the team
+        */
+        void factorize(const execution::Team &team) {
+            const bool cyclic = periodic_ && N > 1;
+            if (team.rank == 0) {
+                if (periodic_ && N == 1) {
+                    diag[0] += lower[0];
+                    diag[0] += upper[0];
+                }
+                if (cyclic) {
+                    E_first = lower[0];
+                    E_last = upper[N - 1];
+                }
+                lower[0] = T(0);
+                upper[N - 1] = T(0);
+            }
+            team.sync();
+
+            factorize_tridiagonal(team);
+            if (!cyclic) return;
+
+            // Z = T^-1 [e_0, e_N-1] (x) I_b
+            auto [begin, end] = team.chunk(N);
+            for (size_t i = begin; i < end; i++) {
+                Z[i] = matrix<T>(b, 2 * b);
+                Z[i] = T(0);
+                for (size_t j = 0; j < b; j++) {
+                    if (i == 0)     Z[i](j, j) = T(1);
+                    if (i == N - 1) Z[i](j, b + j) = T(1);
+                }
+            }
+            team.sync();
+            solve_tridiagonal(team, Z);
+
+            // capacitance matrix I + V^T Z with V^T x = [E_first x_N-1; E_last x_0]
+            if (team.rank == 0) {
+                matrix<T> top = E_first * Z[N - 1];
+                matrix<T> bottom = E_last * Z[0];
+                matrix<T> C(2 * b, 2 * b);
+                for (size_t i = 0; i < b; i++) {
+                    for (size_t j = 0; j < 2 * b; j++) {
+                        C(i, j)     = top(i, j)    + (i == j ? T(1) : T(0));
+                        C(b + i, j) = bottom(i, j) + (b + i == j ? T(1) : T(0));
+                    }
+                }
+                capacitance.emplace(std::move(C));
+            }
+            team.sync();
+        }
+
+        void factorize() {
+            factorize(execution::Team{});
+        }
+
+        /*
+            solve A x = rhs in place, x holds N * b values in block order
+        */
+        void solve(const execution::Team &team, T *x) {
+            if (team.rank == 0 && y.size() != N) y.assign(N, matrix<T>(b, 1));
+            team.sync();
+
+            auto [begin, end] = team.chunk(N);
+            for (size_t i = begin; i < end; i++) {
+                for (size_t j = 0; j < b; j++) y[i](j, 0) = x[i * b + j];
+            }
+            team.sync();
+            solve_tridiagonal(team, y);
+
+            if (periodic_ && N > 1) {
+                if (team.rank == 0) {
+                    matrix<T> top = E_first * y[N - 1];
+                    matrix<T> bottom = E_last * y[0];
+                    s = matrix<T>(2 * b, 1);
+                    for (size_t j = 0; j < b; j++) {
+                        s(j, 0) = top(j, 0);
+                        s(b + j, 0) = bottom(j, 0);
+                    }
+                    capacitance->solve_in_place(s);
+                }
+                team.sync();
+                for (size_t i = begin; i < end; i++) {
+                    y[i] -= Z[i] * s;
+                }
+            }
+
+            for (size_t i = begin; i < end; i++) {
+                for (size_t j = 0; j < b; j++) x[i * b + j] = y[i](j, 0);
+            }
+            team.sync();
+        }
+
+        void solve(T *x) {
+            solve(execution::Team{}, x);
+        }
+    };
+}
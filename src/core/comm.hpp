@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include "types.hpp"
+
+#ifdef DG_HAS_MPI
+#include <mpi.h>
+#endif
+
+namespace DG::core::mpi {
+    /**
+     * @brief MPI initialization and finalization (RAII)
+     *
+     * MPI calls are only made by the first thread of a pool, so FUNNELED thread support is
+     * requested. Without DG_HAS_MPI this does nothing.
+     */
+    class Environment {
+    public:
+        Environment(int &argc, char **&argv) {
+#ifdef DG_HAS_MPI
+            int provided;
+            MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+#else
+            (void)argc; (void)argv;
+#endif
+        }
+
+        Environment(const Environment&) = delete;
+        Environment& operator=(const Environment&) = delete;
+
+        ~Environment() {
+#ifdef DG_HAS_MPI
+            MPI_Finalize();
+#endif
+        }
+    };
+
+    /**
+     * @brief the few collective and point-to-point operations used by the solver
+     *
+     * Wraps MPI_COMM_WORLD when MPI is initialized and `distributed` is set; otherwise (or
+     * without DG_HAS_MPI) it is a single rank for which the collectives are copies.
+     */
+    class Communicator {
+    private:
+
+        int rank_ = 0;
+        int size_ = 1;
+        int local_rank_ = 0;    // among the ranks on the same node
+
+#ifdef DG_HAS_MPI
+        MPI_Comm comm = MPI_COMM_NULL;
+        std::vector<MPI_Request> requests;
+#endif
+
+    public:
+        Communicator(bool distributed = true) {
+#ifdef DG_HAS_MPI
+            int initialized = 0;
+            MPI_Initialized(&initialized);
+            if (initialized && distributed) {
+                comm = MPI_COMM_WORLD;
+                MPI_Comm_rank(comm, &rank_);
+                MPI_Comm_size(comm, &size_);
+
+                MPI_Comm node;
+                MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL, &node);
+                MPI_Comm_rank(node, &local_rank_);
+                MPI_Comm_free(&node);
+            }
+#else
+            (void)distributed;
+#endif
+        }
+
+        int rank() const { return rank_; }
+        int size() const { return size_; }
+        int local_rank() const { return local_rank_; }
+
+        scalar_t allreduce_min(scalar_t value) const {
+#ifdef DG_HAS_MPI
+            if (size_ > 1) {
+                MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_MIN, comm);
+            }
+#endif
+            return value;
+        }
+
+        scalar_t allreduce_max(scalar_t value) const {
+#ifdef DG_HAS_MPI
+            if (size_ > 1) {
+                MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_MAX, comm);
+            }
+#endif
+            return value;
+        }
+
+        scalar_t allreduce_sum(scalar_t value) const {
+#ifdef DG_HAS_MPI
+            if (size_ > 1) {
+                MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_SUM, comm);
+            }
+#endif
+            return value;
+        }
+
+        // nonblocking point-to-point, completed by `wait_all`
+        void isend(const scalar_t *data, size_t n, int dest, int tag) {
+#ifdef DG_HAS_MPI
+            requests.emplace_back();
+            MPI_Isend(data, n, MPI_DOUBLE, dest, tag, comm, &requests.back());
+#else
+            (void)data; (void)n; (void)dest; (void)tag;
+            assert(false && "Point-to-point communication requires MPI.");
+#endif
+        }
+
+        void irecv(scalar_t *data, size_t n, int source, int tag) {
+#ifdef DG_HAS_MPI
+            requests.emplace_back();
+            MPI_Irecv(data, n, MPI_DOUBLE, source, tag, comm, &requests.back());
+#else
+            (void)data; (void)n; (void)source; (void)tag;
+            assert(false && "Point-to-point communication requires MPI.");
+#endif
+        }
+
+        void wait_all() {
+#ifdef DG_HAS_MPI
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+            requests.clear();
+#endif
+        }
+
+        // concatenation of `local` of all ranks (in rank order) on `root`
+        void gather(const std::vector<scalar_t> &local, std::vector<scalar_t> &global, int root = 0) const {
+#ifdef DG_HAS_MPI
+            if (size_ > 1) {
+                int n = local.size();
+                std::vector<int> counts(size_), offsets(size_, 0);
+                MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+                if (rank_ == root) {
+                    for (int r = 1; r < size_; r++) offsets[r] = offsets[r-1] + counts[r-1];
+                    global.resize(offsets[size_-1] + counts[size_-1]);
+                }
+                MPI_Gatherv(local.data(), n, MPI_DOUBLE, global.data(), counts.data(), offsets.data(), MPI_DOUBLE, root, comm);
+                return;
+            }
+#endif
+            (void)root;
+            global = local;
+        }
+    };
+}
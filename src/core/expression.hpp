@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace DG::core{
+    /**
+     * @brief lazy expression templates for `vec` and `matrix`
+     *
+     * Element-wise arithmetic on vectors and matrices builds a light-weight expression tree
+     * instead of a temporary container. The tree is evaluated in a single loop when it is
+     * assigned to (or used to construct) a container, so a whole Runge-Kutta update such as
+     * `u = (u0 + u * 2.0 + dudt * dt * 2.0) / 3.0` costs no allocation.
+     *
+     * Every expression exposes `size()` and the flat element access `elem(i)`. Matrix
+     * expressions additionally forward `rows()` and `cols()` of their leftmost matrix operand.
+     *
+     * NOTE: containers are captured by reference, do not store an expression with `auto` when
+     * one of its operands is a temporary.
+     */
+    struct expression_base {};                      // tag of all expressions (containers and nodes)
+    struct expression_node : expression_base {};    // tag of intermediate (non-owning) nodes
+
+    template<typename E>
+    concept expression = std::is_base_of_v<expression_base, std::remove_cvref_t<E>>;
+
+    template<typename E>
+    concept expression_tree = std::is_base_of_v<expression_node, std::remove_cvref_t<E>>;
+
+    template<typename E>
+    concept matrix_expression = expression<E> && requires(const E &e) { e.rows(); e.cols(); };
+
+    template<typename S>
+    concept scalar = std::is_arithmetic_v<S>;
+
+    // containers are held by reference, nodes by value
+    template<typename E>
+    using operand_t = std::conditional_t<expression_tree<E>, const E, const E&>;
+
+    /*
+        element-wise operations
+    */
+    namespace op {
+        struct add { template<typename A, typename B> static auto apply(const A &a, const B &b) { return a + b; } };
+        struct sub { template<typename A, typename B> static auto apply(const A &a, const B &b) { return a - b; } };
+        struct mul { template<typename A, typename B> static auto apply(const A &a, const B &b) { return a * b; } };
+        struct div { template<typename A, typename B> static auto apply(const A &a, const B &b) { return a / b; } };
+    }
+
+    /**
+     * @brief element-wise operation between two expressions
+     */
+    template<typename L, typename R, typename Op>
+    class binary_expr : public expression_node {
+    private:
+        operand_t<L> lhs;
+        operand_t<R> rhs;
+
+    public:
+        using value_type = typename L::value_type;
+
+        binary_expr(const L &lhs, const R &rhs) : lhs(lhs), rhs(rhs) {
+            assert(lhs.size() == rhs.size() && "Size mismatch.");
+        }
+
+        size_t size() const { return lhs.size(); }
+
+        value_type elem(const size_t i) const {
+            return Op::apply(lhs.elem(i), rhs.elem(i));
+        }
+
+        size_t rows() const requires matrix_expression<L> { return lhs.rows(); }
+        size_t cols() const requires matrix_expression<L> { return lhs.cols(); }
+        size_t rows() const requires (!matrix_expression<L> && matrix_expression<R>) { return rhs.rows(); }
+        size_t cols() const requires (!matrix_expression<L> && matrix_expression<R>) { return rhs.cols(); }
+    };
+
+    /**
+     * @brief element-wise operation between an expression and a scalar
+     */
+    template<typename E, typename Op, bool scalar_first = false>
+    class scalar_expr : public expression_node {
+    private:
+        using value_type_ = typename E::value_type;
+
+        operand_t<E> e;
+        value_type_ s;
+
+    public:
+        using value_type = value_type_;
+
+        scalar_expr(const E &e, const value_type &s) : e(e), s(s) {}
+
+        size_t size() const { return e.size(); }
+
+        value_type elem(const size_t i) const {
+            if constexpr (scalar_first) return Op::apply(s, e.elem(i));
+            else return Op::apply(e.elem(i), s);
+        }
+
+        size_t rows() const requires matrix_expression<E> { return e.rows(); }
+        size_t cols() const requires matrix_expression<E> { return e.cols(); }
+    };
+
+    /**
+     * @brief element-wise negation
+     */
+    template<typename E>
+    class negate_expr : public expression_node {
+    private:
+        operand_t<E> e;
+
+    public:
+        using value_type = typename E::value_type;
+
+        negate_expr(const E &e) : e(e) {}
+
+        size_t size() const { return e.size(); }
+
+        value_type elem(const size_t i) const { return -e.elem(i); }
+
+        size_t rows() const requires matrix_expression<E> { return e.rows(); }
+        size_t cols() const requires matrix_expression<E> { return e.cols(); }
+    };
+
+    // operators
+    template<expression L, expression R>
+    auto operator+(const L &lhs, const R &rhs) {
+        return binary_expr<L, R, op::add>(lhs, rhs);
+    }
+
+    template<expression L, expression R>
+    auto operator-(const L &lhs, const R &rhs) {
+        return binary_expr<L, R, op::sub>(lhs, rhs);
+    }
+
+    template<expression E>
+    auto operator-(const E &e) {
+        return negate_expr<E>(e);
+    }
+
+    template<expression E, scalar S>
+    auto operator*(const E &e, const S &s) {
+        return scalar_expr<E, op::mul>(e, s);
+    }
+
+    template<expression E, scalar S>
+    auto operator*(const S &s, const E &e) {
+        return scalar_expr<E, op::mul, true>(e, s);
+    }
+
+    template<expression E, scalar S>
+    auto operator/(const E &e, const S &s) {
+        return scalar_expr<E, op::div>(e, s);
+    }
+}
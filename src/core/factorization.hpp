@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "matrix.hpp"
+
+namespace DG::core{
+    /**
+     * @brief LU factorization with partial pivoting, P A = L U
+     *
+     * L (unit lower) and U are stored in place of A. The factorization is right-looking and
+     * blocked: a panel of `block` columns is factorized, then the trailing matrix is updated
+     * with contiguous row operations. Solves work for a vector or a multi-RHS matrix.
+     */
+    template<typename T>
+    class LU {
+    private:
+
+        matrix<T> A_;               // L and U
+        std::vector<size_t> piv;    // row i was swapped with row piv[i]
+
+    public:
+        static constexpr size_t Block = 32;
+
+        // constructors: factorize a copy, or the moved-in matrix in place
+        LU(const matrix<T> &A, size_t block = Block) : A_(A) {
+            factorize(A_, piv, block);
+        }
+
+        LU(matrix<T> &&A, size_t block = Block) : A_(std::move(A)) {
+            factorize(A_, piv, block);
+        }
+
+        /*
+            in-place blocked factorization of A, row swaps are written to piv
+        */
+        static void factorize(matrix<T> &A, std::vector<size_t> &piv, size_t block = Block) {
+            assert(A.rows() == A.cols());
+            const size_t n = A.rows();
+            piv.resize(n);
+
+            auto swap_rows = [&](size_t r1, size_t r2) {
+                if (r1 == r2) return;
+                for (size_t j = 0; j < n; j++) {
+                    std::swap(A(r1, j), A(r2, j));
+                }
+            };
+
+            for (size_t k0 = 0; k0 < n; k0 += block) {
+                const size_t k1 = std::min(k0 + block, n);     // panel columns [k0, k1)
+
+                // panel factorization
+                for (size_t k = k0; k < k1; k++) {
+                    size_t p = k;
+                    for (size_t i = k + 1; i < n; i++) {
+                        if (std::abs(A(i, k)) > std::abs(A(p, k))) p = i;
+                    }
+                    piv[k] = p;
+                    swap_rows(k, p);
+                    assert(A(k, k) != T(0) && "Singular matrix.");
+
+                    for (size_t i = k + 1; i < n; i++) {
+                        A(i, k) /= A(k, k);
+                        for (size_t j = k + 1; j < k1; j++) {
+                            A(i, j) -= A(i, k) * A(k, j);
+                        }
+                    }
+                }
+
+                // U12 = L11^-1 A12
+                for (size_t k = k0; k < k1; k++) {
+                    for (size_t i = k + 1; i < k1; i++) {
+                        const T l = A(i, k);
+                        for (size_t j = k1; j < n; j++) {
+                            A(i, j) -= l * A(k, j);
+                        }
+                    }
+                }
+
+                // A22 -= L21 U12
+                for (size_t i = k1; i < n; i++) {
+                    for (size_t k = k0; k < k1; k++) {
+                        const T l = A(i, k);
+                        for (size_t j = k1; j < n; j++) {
+                            A(i, j) -= l * A(k, j);
+                        }
+                    }
+                }
+            }
+        }
+
+        /*
+            solve A x = b, b is overwritten by x
+        */
+        void solve_in_place(vec<T> &b) const {
+            const size_t n = A_.rows();
+            assert(b.size() == n);
+
+            for (size_t i = 0; i < n; i++) {
+                std::swap(b[i], b[piv[i]]);
+            }
+            for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < i; k++) {
+                    b[i] -= A_(i, k) * b[k];
+                }
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; k++) {
+                    b[i] -= A_(i, k) * b[k];
+                }
+                b[i] /= A_(i, i);
+            }
+        }
+
+        /*
+            solve A X = B for all columns of B, B is overwritten by X
+        */
+        void solve_in_place(matrix<T> &B) const {
+            const size_t n = A_.rows();
+            const size_t m = B.cols();
+            assert(B.rows() == n);
+
+            for (size_t i = 0; i < n; i++) {
+                if (piv[i] == i) continue;
+                for (size_t j = 0; j < m; j++) {
+                    std::swap(B(i, j), B(piv[i], j));
+                }
+            }
+            for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < i; k++) {
+                    const T l = A_(i, k);
+                    for (size_t j = 0; j < m; j++) {
+                        B(i, j) -= l * B(k, j);
+                    }
+                }
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; k++) {
+                    const T u = A_(i, k);
+                    for (size_t j = 0; j < m; j++) {
+                        B(i, j) -= u * B(k, j);
+                    }
+                }
+                for (size_t j = 0; j < m; j++) {
+                    B(i, j) /= A_(i, i);
+                }
+            }
+        }
+
+        vec<T> solve(vec<T> b) const {
+            solve_in_place(b);
+            return b;
+        }
+
+        matrix<T> solve(matrix<T> B) const {
+            solve_in_place(B);
+            return B;
+        }
+
+        // Accessors
+        const matrix<T>& factors() const { return A_; }
+        const std::vector<size_t>& pivots() const { return piv; }
+    };
+
+    /**
+     * @brief Cholesky factorization of a symmetric positive definite matrix, A = L L^T
+     *
+     * e.g. the mass matrix; L is stored in the lower triangle.
+     */
+    template<typename T>
+    class Cholesky {
+    private:
+
+        matrix<T> L_;
+
+    public:
+        Cholesky(const matrix<T> &A) : L_(A) {
+            factorize(L_);
+        }
+
+        Cholesky(matrix<T> &&A) : L_(std::move(A)) {
+            factorize(L_);
+        }
+
+        /*
+            in-place factorization, the strict upper triangle is set to zero
+        */
+        static void factorize(matrix<T> &A) {
+            assert(A.rows() == A.cols());
+            const size_t n = A.rows();
+
+            for (size_t j = 0; j < n; j++) {
+                T d = A(j, j);
+                for (size_t k = 0; k < j; k++) {
+                    d -= A(j, k) * A(j, k);
+                }
+                assert(d > T(0) && "Matrix is not positive definite.");
+                A(j, j) = std::sqrt(d);
+
+                for (size_t i = j + 1; i < n; i++) {
+                    T s = A(i, j);
+                    for (size_t k = 0; k < j; k++) {
+                        s -= A(i, k) * A(j, k);
+                    }
+                    A(i, j) = s / A(j, j);
+                    A(j, i) = T(0);
+                }
+            }
+        }
+
+        void solve_in_place(vec<T> &b) const {
+            const size_t n = L_.rows();
+            assert(b.size() == n);
+
+            for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < i; k++) {
+                    b[i] -= L_(i, k) * b[k];
+                }
+                b[i] /= L_(i, i);
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; k++) {
+                    b[i] -= L_(k, i) * b[k];
+                }
+                b[i] /= L_(i, i);
+            }
+        }
+
+        void solve_in_place(matrix<T> &B) const {
+            const size_t n = L_.rows();
+            const size_t m = B.cols();
+            assert(B.rows() == n);
+
+            for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < i; k++) {
+                    const T l = L_(i, k);
+                    for (size_t j = 0; j < m; j++) {
+                        B(i, j) -= l * B(k, j);
+                    }
+                }
+                for (size_t j = 0; j < m; j++) {
+                    B(i, j) /= L_(i, i);
+                }
+            }
+            for (size_t i = n; i-- > 0;) {
+                for (size_t k = i + 1; k < n; k++) {
+                    const T l = L_(k, i);
+                    for (size_t j = 0; j < m; j++) {
+                        B(i, j) -= l * B(k, j);
+                    }
+                }
+                for (size_t j = 0; j < m; j++) {
+                    B(i, j) /= L_(i, i);
+                }
+            }
+        }
+
+        vec<T> solve(vec<T> b) const {
+            solve_in_place(b);
+            return b;
+        }
+
+        matrix<T> solve(matrix<T> B) const {
+            solve_in_place(B);
+            return B;
+        }
+
+        // Accessors
+        const matrix<T>& factor() const { return L_; }
+    };
+
+    template<typename T>
+    LU<T> matrix<T, dynamic, dynamic>::lu() const {
+        return LU<T>(*this);
+    }
+
+    template<typename T>
+    Cholesky<T> matrix<T, dynamic, dynamic>::cholesky() const {
+        return Cholesky<T>(*this);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include "simd.hpp"
+#include "types.hpp"
+
+namespace DG::core::kernels {
+    /* columns per register block of `gemm`; column ranges split at multiples of it take the same code path */
+    inline constexpr size_t GemmColumns = 4 * simd::width<scalar_t>;
+
+    /**
+     * @brief batched small-matrix product Y = A * X
+     *
+     * A is a small (n x n) reference operator, X and Y are tall-and-wide (n x m) row-major blocks
+     * with leading dimensions ldx and ldy, e.g. the volume flux of all cells stored node-major as
+     * [node][cell * NumEqns]. Every output row is accumulated over k in ascending order, the
+     * columns are register blocked in groups of `Block` SIMD packs.
+     *
+     * N > 0 fixes n at compile time so the k loop can be fully unrolled, e.g. with the
+     * operators of a `RefTable<N>`.
+     */
+    template<const size_t N = 0>
+    inline void gemm(const scalar_t *A, const size_t n_, const scalar_t *X, const size_t ldx,
+                     scalar_t *Y, const size_t ldy, const size_t m)
+    {
+        const size_t n = N ? N : n_;
+
+        using pack_t = simd::pack<scalar_t>;
+        constexpr size_t W = simd::width<scalar_t>;
+        constexpr size_t Block = GemmColumns / W;
+
+        size_t j = 0;
+
+        // register blocked columns
+        for (; j + Block * W <= m; j += Block * W) {
+            for (size_t i = 0; i < n; i++) {
+                pack_t acc[Block];
+                for (size_t b = 0; b < Block; b++) acc[b] = 0.0;
+
+                for (size_t k = 0; k < n; k++) {
+                    const pack_t a = A[i * n + k];
+                    const scalar_t *x = X + k * ldx + j;
+                    for (size_t b = 0; b < Block; b++) {
+                        acc[b] += a * simd::load(x + b * W);
+                    }
+                }
+
+                for (size_t b = 0; b < Block; b++) {
+                    simd::store(acc[b], Y + i * ldy + j + b * W);
+                }
+            }
+        }
+
+        // single packs
+        for (; j + W <= m; j += W) {
+            for (size_t i = 0; i < n; i++) {
+                pack_t acc = 0.0;
+                for (size_t k = 0; k < n; k++) {
+                    acc += pack_t(A[i * n + k]) * simd::load(X + k * ldx + j);
+                }
+                simd::store(acc, Y + i * ldy + j);
+            }
+        }
+
+        // remainder
+        for (; j < m; j++) {
+            for (size_t i = 0; i < n; i++) {
+                scalar_t acc = 0.0;
+                for (size_t k = 0; k < n; k++) {
+                    acc += A[i * n + k] * X[k * ldx + j];
+                }
+                Y[i * ldy + j] = acc;
+            }
+        }
+    }
+}
@@ -1,21 +1,35 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include "vector.hpp"
+#include "array.hpp"
 
 namespace DG::core{
+    /* size tag of run-time sized matrices */
+    inline constexpr size_t dynamic = 0;
+
+    template<typename T, const size_t R = dynamic, const size_t C = dynamic>
+    class matrix;
+
+    template<typename T>
+    class LU;
+
+    template<typename T>
+    class Cholesky;
+
     /** 
      * @brief data type: matrix
      * 
      * derived class from `vec` to provide a matrix-like interface
      */
     template<typename T>
-    class matrix : public vec<T> {
+    class matrix<T, dynamic, dynamic> : public vec<T> {
     private:
     
-        size_t n_rows;
-        size_t n_cols;
+        size_t n_rows = 0;
+        size_t n_cols = 0;
 
     public:
         // constructors
@@ -41,6 +55,20 @@ namespace DG::core{
             this->data_ = other.data_;
         }
 
+        matrix(matrix&& other) = default;
+        matrix& operator=(const matrix& other) = default;
+        matrix& operator=(matrix&& other) = default;
+
+        // evaluate a matrix expression
+        template<expression E> requires matrix_expression<E>
+        matrix(const E &e) : n_rows(e.rows()), n_cols(e.cols()) {
+            this->N = e.size();
+            this->data_.resize(this->N);
+            for (size_t i = 0; i < this->N; i++) {
+                this->data_[i] = e.elem(i);
+            }
+        }
+
         matrix() = default;
 
         // destructor
@@ -72,60 +100,43 @@ namespace DG::core{
             return *this;
         }
 
-		matrix operator*(const T &scalar) const {
-            matrix res = *this;
-			for (size_t i = 0; i < this->N; i++) {
-				res.data_[i] *= scalar;
-			}
-			return res;
-		}
-
-		matrix operator/(const T &scalar) const {
-            matrix res = *this;
-			for (size_t i = 0; i < this->N; i++) {
-				res.data_[i] /= scalar;
-			}
-			return res;
-		}
-
-		matrix& operator*=(const T &scalar) {
-			*this = (*this) * scalar;
-			return *this;
-		}
-
-		matrix& operator/=(const T &scalar) {
-			*this = (*this) / scalar;
-			return *this;
-		}
-
-        matrix operator+(const matrix &other) const {
-            matrix result = *this;
-            for (size_t i = 0; i < this->N; i++) {
-                result.data_[i] = this->data_[i] + other.data_[i];
+        template<expression_tree E> requires matrix_expression<E>
+        matrix& operator=(const E &e) {
+            if (n_rows != e.rows() || n_cols != e.cols()) {
+                n_rows = e.rows();
+                n_cols = e.cols();
+                this->resize(e.size());
             }
-            return result;
-        }
-
-        matrix operator-(const matrix &other) const {
-            matrix result = *this;
             for (size_t i = 0; i < this->N; i++) {
-                result.data_[i] = this->data_[i] - other.data_[i];
+                this->data_[i] = e.elem(i);
             }
-            return result;
+            return *this;
         }
 
-        matrix& operator+=(const matrix &other){
-            *this = (*this) + other;
+        template<expression E>
+        matrix& operator+=(const E &e) {
+            vec<T>::operator+=(e);
             return *this;
         }
 
-        matrix& operator-=(const matrix &other){
-            *this = (*this) - other;
+        template<expression E>
+        matrix& operator-=(const E &e) {
+            vec<T>::operator-=(e);
             return *this;
         }
 
+		matrix& operator*=(const T &scalar) {
+			vec<T>::operator*=(scalar);
+			return *this;
+		}
+
+		matrix& operator/=(const T &scalar) {
+			vec<T>::operator/=(scalar);
+			return *this;
+		}
+
         // create an indentity matrix
-        matrix identity() {
+        matrix identity() const {
             matrix res(n_rows, n_cols);
             for (size_t i = 0; i < n_rows; i++) {
                 for (size_t j = 0; j < n_cols; j++) {
@@ -136,7 +147,7 @@ namespace DG::core{
         }
 
         // matrix transpose
-        matrix transpose() {
+        matrix transpose() const {
             matrix res(n_cols, n_rows);
             for (size_t i = 0; i < n_rows; i++) {
                 for (size_t j = 0; j < n_cols; j++) {
@@ -146,69 +157,26 @@ namespace DG::core{
             return res;
         }
 
-        // matrix inverse
-        matrix inv() {
+        // matrix inverse, prefer lu().solve() or cholesky().solve() when the inverse is only applied
+        matrix inv() const {
             assert(n_rows == n_cols);
-            matrix target = *this;
-            matrix res = (*this).identity();
-            size_t n = n_rows;           
-
-            auto swapRows = [&](matrix& res, size_t row1, size_t row2) {
-                for (size_t k = 0; k < n_cols; k++) {
-                    std::swap(res(row1, k), res(row2, k));
-                }
-            };
-
-            // Perform Gaussian elimination with partial pivoting
-            for (size_t i = 0; i < n; ++i) {
-                // Find the pivot element
-                double maxElement = std::abs(target(i, i));
-                int maxRow = i;
-                for (size_t k = i + 1; k < n; ++k) {
-                    if (std::abs(target(k, i)) > maxElement) {
-                        maxElement = std::abs(target(k, i));
-                        maxRow = k;
-                    }
-                }
-
-                // Swap the maximum element row with the current row in both matrices
-                swapRows(target, i, maxRow);
-                swapRows(res   , i, maxRow);
-
-                // Make the diagonal element 1
-                double div = target(i, i);
-                for (size_t j = i; j < n; ++j) {
-                    target(i, j) /= div;
-                }
-                for (size_t j = 0; j < n; ++j) {
-                    res(i, j) /= div;
-                }
-
-                // Make other elements in this column zero
-                for (size_t j = 0; j < n; ++j) {
-                    if (j != i) {
-                        double factor = target(j, i);
-                        for (size_t k = i; k < n; ++k) {
-                            target(j, k) -= factor * target(i, k);
-                        }
-                        for (size_t k = 0; k < n; ++k) {
-                            res(j, k) -= factor * res(i, k);
-                        }
-                    }
-                }
-            }   
-
-            return res;
+            return lu().solve(identity());
         }
 
-        void fill_column(size_t col, const vec<T>& v) {
+        // factorizations, see factorization.hpp
+        LU<T> lu() const;
+        Cholesky<T> cholesky() const;
+
+        template<typename V>
+        void fill_column(size_t col, const V& v) {
             assert(v.size() == n_rows);
             for (size_t i = 0; i < n_rows; i++) {
                 (*this)(i, col) = v[i];
             }
         }
 
-        void fill_row(size_t row, const vec<T>& v) {
+        template<typename V>
+        void fill_row(size_t row, const V& v) {
             assert(v.size() == n_cols);
             for (size_t i = 0; i < n_cols; i++) {
                 (*this)(row, i) = v[i];
@@ -222,6 +190,263 @@ namespace DG::core{
     }; // end of matrix class
 
 
+    /**
+     * @brief data type: fixed size matrix
+     *
+     * row-major matrix with compile-time dimensions stored in a std::array,
+     * so it lives inline (e.g. inside a cell) without any heap allocation
+     */
+    template<typename T, const size_t R, const size_t C>
+    class matrix : public expression_base {
+    private:
+
+        static constexpr size_t N = R * C;
+        std::array<T, N> data_{};   // elements
+
+    public:
+        using value_type = T;
+
+        // constructors
+        matrix() = default;
+
+        matrix(size_t rows, size_t cols) {
+            assert(rows == R && cols == C && "Size mismatch.");
+        }
+
+        // evaluate a matrix expression
+        template<expression E> requires matrix_expression<E>
+        matrix(const E &e) {
+            assert(e.rows() == R && e.cols() == C && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] = e.elem(i);
+            }
+        }
+
+        // element reference
+        T& operator()(const size_t i, const size_t j) {
+            return data_[i*C + j];
+        }
+
+        const T& operator()(const size_t i, const size_t j) const {
+            return data_[i*C + j];
+        }
+
+        // copy of the whole row, fixed size
+        arr<T, C> operator[](const size_t row) const {
+            arr<T, C> res;
+            for (size_t i = 0; i < C; i++) {
+                res[i] = (*this)(row, i);
+            }
+            return res;
+        }
+
+        // operators
+        matrix& operator=(const T& value) {
+            data_.fill(value);
+            return *this;
+        }
+
+        template<expression_tree E> requires matrix_expression<E>
+        matrix& operator=(const E &e) {
+            assert(e.rows() == R && e.cols() == C && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] = e.elem(i);
+            }
+            return *this;
+        }
+
+        template<expression E>
+        matrix& operator+=(const E &e) {
+            assert(e.size() == N && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] += e.elem(i);
+            }
+            return *this;
+        }
+
+        template<expression E>
+        matrix& operator-=(const E &e) {
+            assert(e.size() == N && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] -= e.elem(i);
+            }
+            return *this;
+        }
+
+        matrix& operator*=(const T &scalar) {
+            for (size_t i = 0; i < N; i++) {
+                data_[i] *= scalar;
+            }
+            return *this;
+        }
+
+        matrix& operator/=(const T &scalar) {
+            for (size_t i = 0; i < N; i++) {
+                data_[i] /= scalar;
+            }
+            return *this;
+        }
+
+        template<typename V>
+        void fill_column(size_t col, const V& v) {
+            assert(v.size() == R);
+            for (size_t i = 0; i < R; i++) {
+                (*this)(i, col) = v[i];
+            }
+        }
+
+        template<typename V>
+        void fill_row(size_t row, const V& v) {
+            assert(v.size() == C);
+            for (size_t i = 0; i < C; i++) {
+                (*this)(row, i) = v[i];
+            }
+        }
+
+        // flat element access used by expressions
+        const T& elem(const size_t i) const {
+            return data_[i];
+        }
+
+        // raw storage
+        T* data() { return data_.data(); }
+        const T* data() const { return data_.data(); }
+
+        // Accessors
+        static constexpr size_t size() { return N; }
+        static constexpr size_t rows() { return R; }
+        static constexpr size_t cols() { return C; }
+
+    }; // end of fixed size matrix class
+
+
+    /**
+     * @brief data type: matrix view
+     *
+     * row-major matrix over storage owned by someone else, e.g. the block of one cell in a
+     * global field buffer. Copying a view rebinds it, assigning to a view writes the elements.
+     * R = `dynamic` takes the number of rows at run time.
+     */
+    template<typename T, const size_t R, const size_t C>
+    class matrix_view : public expression_base {
+    private:
+
+        T *data_ = nullptr;
+        size_t n_rows = R;
+
+    public:
+        using value_type = T;
+
+        // constructors
+        matrix_view() = default;
+        matrix_view(T *data, size_t rows = R) : data_(data), n_rows(rows) {
+            assert((R == dynamic || rows == R) && "Size mismatch.");
+        }
+        matrix_view(const matrix_view &other) = default;
+
+        // element reference
+        T& operator()(const size_t i, const size_t j) {
+            return data_[i*C + j];
+        }
+
+        const T& operator()(const size_t i, const size_t j) const {
+            return data_[i*C + j];
+        }
+
+        // copy of the whole row, fixed size
+        arr<T, C> operator[](const size_t row) const {
+            arr<T, C> res;
+            for (size_t i = 0; i < C; i++) {
+                res[i] = (*this)(row, i);
+            }
+            return res;
+        }
+
+        // operators
+        matrix_view& operator=(const T& value) {
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] = value;
+            }
+            return *this;
+        }
+
+        matrix_view& operator=(const matrix_view &other) {
+            assert(other.size() == size() && "Size mismatch.");
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] = other.data_[i];
+            }
+            return *this;
+        }
+
+        template<expression E> requires matrix_expression<E>
+        matrix_view& operator=(const E &e) {
+            assert(e.rows() == rows() && e.cols() == C && "Size mismatch.");
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] = e.elem(i);
+            }
+            return *this;
+        }
+
+        template<expression E>
+        matrix_view& operator+=(const E &e) {
+            assert(e.size() == size() && "Size mismatch.");
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] += e.elem(i);
+            }
+            return *this;
+        }
+
+        template<expression E>
+        matrix_view& operator-=(const E &e) {
+            assert(e.size() == size() && "Size mismatch.");
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] -= e.elem(i);
+            }
+            return *this;
+        }
+
+        matrix_view& operator*=(const T &scalar) {
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] *= scalar;
+            }
+            return *this;
+        }
+
+        matrix_view& operator/=(const T &scalar) {
+            for (size_t i = 0; i < size(); i++) {
+                data_[i] /= scalar;
+            }
+            return *this;
+        }
+
+        template<typename V>
+        void fill_row(size_t row, const V& v) {
+            assert(v.size() == C);
+            for (size_t i = 0; i < C; i++) {
+                (*this)(row, i) = v[i];
+            }
+        }
+
+        // flat element access used by expressions
+        const T& elem(const size_t i) const {
+            return data_[i];
+        }
+
+        // raw storage
+        T* data() { return data_; }
+        const T* data() const { return data_; }
+
+        // Accessors
+        size_t rows() const {
+            if constexpr (R == dynamic) return n_rows;
+            else return R;
+        }
+        static constexpr size_t cols() { return C; }
+        size_t size() const { return rows() * C; }
+
+    }; // end of matrix view class
+
+
     // matrix-matrix multiplication
     template<typename T>
     matrix<T> operator*(const matrix<T> &M1, const matrix<T> &M2) {
@@ -240,6 +465,36 @@ namespace DG::core{
         return result;
     }
 
+    // matrix-matrix multiplication with a fixed size right hand side, e.g. a reference
+    // operator applied to the state of a cell
+    template<typename T, const size_t R, const size_t C>
+    matrix<T, R, C> operator*(const matrix<T> &M1, const matrix<T, R, C> &M2) {
+
+        assert(M1.rows() == R && M1.cols() == R);
+        matrix<T, R, C> result;
+
+        for (size_t i = 0; i < R; i++) {
+            for (size_t j = 0; j < C; j++) {
+                result(i, j) = 0;
+                for (size_t k = 0; k < R; k++) {
+                    result(i, j) += M1(i, k) * M2(k, j);
+                }
+            }
+        }
+        return result;
+    }
+
+    // matrix-expression multiplication: the expression is evaluated once before the product
+    template<typename T, expression_tree E> requires matrix_expression<E>
+    matrix<T> operator*(const matrix<T> &M1, const E &M2) {
+        return M1 * matrix<T>(M2);
+    }
+
+    template<typename T, expression_tree E>
+    vec<T> operator*(const matrix<T> &M, const E &v) {
+        return M * vec<T>(v);
+    }
+
     // matrix-vector multiplication
     template<typename T>
     vec<T> operator*(const matrix<T> &M, const vec<T> &v) {
@@ -271,3 +526,4 @@ namespace DG::core{
     }
 }
 
+#include "factorization.hpp"
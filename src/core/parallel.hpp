@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "scheduler.hpp"
+#include "types.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace DG::core::execution {
+    /**
+     * @brief execution policies, in the spirit of `std::execution`
+     *
+     * seq: every loop runs on the calling thread
+     * par: loops are split into contiguous chunks run by a `ThreadPool`; threads = 0 uses
+     *      DG_NUM_THREADS from the environment, or the hardware concurrency. With
+     *      work_stealing, the cell and face loops are scheduled by `WorkStealing` instead,
+     *      with pin, the threads of the pool are bound to cores
+     */
+    struct sequenced_policy {};
+
+    struct parallel_policy {
+        size_t threads = 0;
+        bool work_stealing = false;
+        bool pin = false;
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+
+    template<typename Policy>
+    inline constexpr bool is_parallel = std::is_same_v<Policy, parallel_policy>;
+
+    inline size_t default_threads() {
+        if (const char *env = std::getenv("DG_NUM_THREADS")) {
+            size_t n = std::stoul(env);
+            if (n > 0) return n;
+        }
+        return std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief reusable spinning barrier for the threads of a pool
+     *
+     * The last thread to arrive releases the others by advancing the generation counter.
+     * Waiting threads spin briefly and then yield, so oversubscribed runs still progress.
+     */
+    class Barrier {
+    private:
+
+        const size_t n;
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> generation{0};
+
+    public:
+        explicit Barrier(size_t n) : n(n) {}
+
+        void arrive_and_wait() {
+            const size_t gen = generation.load(std::memory_order_acquire);
+            if (count.fetch_add(1, std::memory_order_acq_rel) + 1 == n) {
+                count.store(0, std::memory_order_relaxed);
+                generation.fetch_add(1, std::memory_order_release);
+                return;
+            }
+            for (size_t spin = 0; generation.load(std::memory_order_acquire) == gen; spin++) {
+                if (spin >= 1024) std::this_thread::yield();
+            }
+        }
+    };
+
+    /* [begin, end) of chunk t when n items are split into T chunks, boundaries are multiples of grain */
+    inline std::pair<size_t, size_t> chunk(size_t t, size_t T, size_t n, size_t grain = 1) {
+        const size_t units = (n + grain - 1) / grain;
+        size_t begin = std::min(n, (units * t / T) * grain);
+        size_t end   = std::min(n, (units * (t + 1) / T) * grain);
+        return {begin, end};
+    }
+
+    /**
+     * @brief handle of one thread in a parallel region
+     *
+     * Every thread owns the static chunk `chunk(n)` of each loop, `sync` is a barrier across the
+     * team and `reduce` combines one value per thread in rank order. The default team is the
+     * calling thread alone, for which all of these are trivial.
+     *
+     * `for_each` runs f(begin, end) on the static chunk, or on the tasks a thread gets from the
+     * work-stealing scheduler. In the latter case the ranges of a thread change from loop to
+     * loop, so `for_each` ends with a barrier.
+     */
+    struct Team {
+        size_t rank = 0;
+        size_t size = 1;
+        Barrier *barrier = nullptr;
+        std::vector<scalar_t> *scratch = nullptr;   // one slot per thread for reductions
+        WorkStealing *stealer = nullptr;            // null: static chunks
+
+        std::pair<size_t, size_t> chunk(size_t n, size_t grain = 1) const {
+            return execution::chunk(rank, size, n, grain);
+        }
+
+        bool stealing() const {
+            return stealer != nullptr;
+        }
+
+        // cost: optional per-item cost for balancing the tasks
+        template<typename F>
+        void for_each(size_t n, F &&f, const scalar_t *cost = nullptr) const {
+            if (stealer) {
+                stealer->run(rank, n, cost, f);
+                sync();
+                return;
+            }
+            auto [begin, end] = chunk(n);
+            if (begin < end) f(begin, end);
+        }
+
+        void sync() const {
+            if (barrier) barrier->arrive_and_wait();
+        }
+
+        template<typename Op>
+        scalar_t reduce(scalar_t value, Op &&op) const {
+            if (size == 1) return value;
+            (*scratch)[rank] = value;
+            sync();
+            scalar_t res = (*scratch)[0];
+            for (size_t t = 1; t < size; t++) res = op(res, (*scratch)[t]);
+            sync();     // the slots may be overwritten by the next reduction
+            return res;
+        }
+
+        // value of rank 0 on all threads
+        scalar_t broadcast(scalar_t value) const {
+            if (size == 1) return value;
+            if (rank == 0) (*scratch)[0] = value;
+            sync();
+            scalar_t res = (*scratch)[0];
+            sync();
+            return res;
+        }
+    };
+
+#ifdef __linux__
+    // cpus the calling thread may run on, in increasing order
+    inline std::vector<int> allowed_cpus(const cpu_set_t &mask) {
+        std::vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &mask)) cpus.push_back(c);
+        }
+        return cpus;
+    }
+
+    // bind the calling thread to one cpu, returns false if the affinity could not be set
+    inline bool pin_to_cpu(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) == 0;
+    }
+#endif
+
+    /**
+     * @brief fixed-size pool of persistent worker threads
+     *
+     * `run` executes one task on all threads (the caller takes part as thread 0) and returns
+     * when every thread has finished. Loops are split statically: chunk t of n items always
+     * covers the same index range, so reductions combine partial results in a fixed order and
+     * the results do not depend on the thread timing.
+     *
+     * With `pin`, thread t (the constructing thread being thread 0) is bound to the cpu
+     * (offset + t) mod n among the n cpus of the affinity mask of the constructing thread, so
+     * a cpuset or a mask set by the MPI launcher is respected; ranks on the same node pass
+     * different offsets. The mask of the constructing thread is restored by the destructor.
+     * Pinning is Linux only, `pinned()` tells whether it succeeded on all threads.
+     */
+    class ThreadPool {
+    private:
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable cv_start;
+        std::condition_variable cv_done;
+
+        Barrier barrier;
+        std::vector<scalar_t> scratch;
+        WorkStealing stealer;
+
+#ifdef __linux__
+        std::vector<int> cpus;          // allowed cpus, empty without pinning
+        cpu_set_t caller_mask;
+        pthread_t caller;
+#endif
+        std::atomic<bool> pin_failed{false};
+
+        const std::function<void(size_t)> *task = nullptr;
+        size_t generation = 0;  // incremented for every task
+        size_t pending = 0;     // workers still running the current task
+        bool stop = false;
+
+        void pin(size_t t, size_t offset) {
+#ifdef __linux__
+            if (!cpus.empty() && !pin_to_cpu(cpus[(offset + t) % cpus.size()])) pin_failed = true;
+#else
+            (void)t; (void)offset;
+#endif
+        }
+
+        void work(size_t t, size_t offset) {
+            pin(t, offset);
+
+            size_t seen = 0;
+            while (true) {
+                const std::function<void(size_t)> *f;
+                {
+                    std::unique_lock lock(mutex);
+                    cv_start.wait(lock, [&] { return stop || generation != seen; });
+                    if (stop) return;
+                    seen = generation;
+                    f = task;
+                }
+
+                (*f)(t);
+
+                std::lock_guard lock(mutex);
+                if (--pending == 0) cv_done.notify_one();
+            }
+        }
+
+    public:
+        explicit ThreadPool(size_t threads = default_threads(), bool pin_threads = false, size_t offset = 0)
+            : barrier(std::max<size_t>(1, threads)), scratch(std::max<size_t>(1, threads)), stealer(std::max<size_t>(1, threads))
+        {
+            threads = std::max<size_t>(1, threads);
+#ifdef __linux__
+            caller = pthread_self();
+            if (pin_threads) {
+                if (pthread_getaffinity_np(caller, sizeof(cpu_set_t), &caller_mask) == 0) {
+                    cpus = allowed_cpus(caller_mask);
+                } else {
+                    pin_failed = true;
+                }
+            }
+#else
+            pin_failed = pin_threads;
+#endif
+            pin(0, offset);
+            for (size_t t = 1; t < threads; t++) {
+                workers.emplace_back([this, t, offset] { work(t, offset); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mutex);
+                stop = true;
+            }
+            cv_start.notify_all();
+            for (auto &w : workers) w.join();
+#ifdef __linux__
+            // only on the constructing thread itself, another thread handle may be stale
+            if (!cpus.empty() && pthread_equal(caller, pthread_self())) {
+                pthread_setaffinity_np(caller, sizeof(cpu_set_t), &caller_mask);
+            }
+#endif
+        }
+
+        // number of threads, including the caller
+        size_t size() const {
+            return workers.size() + 1;
+        }
+
+        // false if pinning was requested and failed on some thread; valid after the first `run`
+        bool pinned() const {
+            return !pin_failed;
+        }
+
+        // run f(t) for t = 0 ... size() - 1, one call per thread
+        void run(const std::function<void(size_t)> &f) {
+            if (workers.empty()) {
+                f(0);
+                return;
+            }
+            {
+                std::lock_guard lock(mutex);
+                task = &f;
+                pending = workers.size();
+                generation++;
+            }
+            cv_start.notify_all();
+
+            f(0);
+
+            std::unique_lock lock(mutex);
+            cv_done.wait(lock, [&] { return pending == 0; });
+        }
+
+        // team handle of thread t, valid inside `run`
+        Team team(size_t t, bool work_stealing = false) {
+            return Team{t, size(), &barrier, &scratch, work_stealing ? &stealer : nullptr};
+        }
+
+        // f(begin, end) on contiguous ranges of [0, n), chunk boundaries are multiples of grain
+        template<typename F>
+        void parallel_for(size_t n, F &&f, size_t grain = 1) {
+            run([&](size_t t) {
+                auto [begin, end] = execution::chunk(t, size(), n, grain);
+                if (begin < end) f(begin, end);
+            });
+        }
+    };
+}
@@ -1,29 +1,75 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <numbers>
 #include "types.hpp"
 
 namespace DG::core{
     /**
      *  @brief the Legendre polynomials
+     *
+     *  evaluated with the three-term recurrence in O(n); `table` returns all degrees
+     *  0..n for a batch of points in one pass
      */
     struct Legendre {
+        /* value, first and second derivative of P_n at one point */
+        struct Value {
+            scalar_t p;
+            scalar_t dp;
+            scalar_t d2p;
+        };
+
+        static constexpr Value eval(scalar_t x, size_t n) {
+            scalar_t p0 = 1.0, dp0 = 0.0, d2p0 = 0.0;   // degree k-1
+            if (n == 0) return {p0, dp0, d2p0};
+
+            scalar_t p1 = x, dp1 = 1.0, d2p1 = 0.0;     // degree k
+            for (size_t k = 2; k <= n; k++) {
+                scalar_t p2   = (2.0*k-1.0)/k * x * p1 - (k-1.0)/k * p0;
+                scalar_t d2p2 = (k + 1) * dp1 + x * d2p1;
+                scalar_t dp2  = k * p1 + x * dp1;
+                p0 = p1; p1 = p2;
+                dp1 = dp2;
+                d2p1 = d2p2;
+            }
+            return {p1, dp1, d2p1};
+        }
+
         static scalar_t poly (scalar_t x, size_t n) {
-            if (n == 0) return 1.0;
-            if (n == 1) return x;
-            return (2.0*n-1.0)/n * x * poly(x, n-1) - (n-1.0)/n * poly(x, n-2);
+            return eval(x, n).p;
         }
 
         static scalar_t d_poly (scalar_t x, size_t n) {
-            if (n == 0) return 0.0;
-            return n * poly(x, n-1) + x * d_poly(x, n - 1);
+            return eval(x, n).dp;
         }
 
         static scalar_t d2_poly (scalar_t x, size_t n) {
-            if (n == 0) return 0.0;
-            if (n == 1) return 0.0;
-            return (n + 1) * d_poly(x, n-1) + x * d2_poly(x, n - 1);
+            return eval(x, n).d2p;
+        }
+
+        /*
+            P(i, k) = P_k(x_i) and dP(i, k) = P_k'(x_i) for all points and degrees 0..n
+        */
+        static void table(const vec_t &x, size_t n, mat_t &P, mat_t &dP) {
+            P  = mat_t(x.size(), n + 1);
+            dP = mat_t(x.size(), n + 1);
+
+            for (size_t i = 0; i < x.size(); i++) {
+                P(i, 0) = 1.0;
+                dP(i, 0) = 0.0;
+                if (n == 0) continue;
+
+                P(i, 1) = x[i];
+                dP(i, 1) = 1.0;
+                for (size_t k = 2; k <= n; k++) {
+                    P(i, k)  = (2.0*k-1.0)/k * x[i] * P(i, k-1) - (k-1.0)/k * P(i, k-2);
+                    dP(i, k) = k * P(i, k-1) + x[i] * dP(i, k-1);
+                }
+            }
         }
     };
 
@@ -76,36 +122,115 @@ namespace DG::core{
         ~Chebyshev2() = default;
     };
 
+    /**
+     *  @brief method used to find the roots of the quadrature polynomials
+     *
+     *  Newton:      Newton-Raphson from Chebyshev initial guesses
+     *  GolubWelsch: eigenvalues of the Jacobi matrix, polished by Newton
+     *  Auto:        Newton for small n, Golub-Welsch from `GolubWelschMinNodes` on
+     */
+    enum class NodeSolver {
+        Newton,
+        GolubWelsch,
+        Auto
+    };
+
+    inline constexpr size_t GolubWelschMinNodes = 40;
+
+    /**
+     *  @brief eigenvalues of a symmetric tridiagonal matrix (implicit QL), in place
+     *
+     *  d: diagonal, overwritten by the eigenvalues in ascending order
+     *  e: e[i] couples rows i and i+1, destroyed on output
+     */
+    inline void tridiagonal_eigenvalues(vec_t &d, vec_t &e) {
+        const long n = d.size();
+        if (n == 0) return;
+        e[n-1] = 0.0;
+
+        for (long l = 0; l < n; l++) {
+            long m;
+            size_t iter = 0;
+            do {
+                for (m = l; m < n - 1; m++) {
+                    scalar_t dd = std::abs(d[m]) + std::abs(d[m+1]);
+                    if (std::abs(e[m]) <= std::numeric_limits<scalar_t>::epsilon() * dd) break;
+                }
+                if (m != l) {
+                    assert(iter++ < 60 && "Too many QL iterations.");
+
+                    scalar_t g = (d[l+1] - d[l]) / (2.0 * e[l]);
+                    scalar_t r = std::hypot(g, 1.0);
+                    g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+
+                    scalar_t s = 1.0, c = 1.0, p = 0.0;
+                    long i;
+                    for (i = m - 1; i >= l; i--) {
+                        scalar_t f = s * e[i];
+                        scalar_t b = c * e[i];
+                        e[i+1] = (r = std::hypot(f, g));
+                        if (r == 0.0) {
+                            d[i+1] -= p;
+                            e[m] = 0.0;
+                            break;
+                        }
+                        s = f / r;
+                        c = g / r;
+                        g = d[i+1] - p;
+                        r = (d[i] - g) * s + 2.0 * c * b;
+                        d[i+1] = g + (p = s * r);
+                        g = c * r - b;
+                    }
+                    if (r == 0.0 && i >= l) continue;
+                    d[l] -= p;
+                    e[l] = g;
+                    e[m] = 0.0;
+                }
+            } while (m != l);
+        }
+
+        std::sort(d.data(), d.data() + n);
+    }
+
     /**
      *  @brief Gauss-Legendre quadrature (exclude end points)
      */
     class Gaussian : public Quadrature{
     public:
-        // compute Gaussian quadrature points and weights using Newton-Rapson
-        Gaussian(size_t n) : Quadrature(n) {
-            // initial guess
-            Chebyshev2 Cheb2Q(n);
-            x = Cheb2Q.x;
-
-            vec_t x_prev(n);
-            x_prev = 2.0;
-            vec_t x_diff = x - x_prev;
+        // compute Gaussian quadrature points (roots of P_n) and weights
+        Gaussian(size_t n, NodeSolver solver = NodeSolver::Auto, scalar_t tol = 1e-15, size_t max_iter = 100) : Quadrature(n) {
+            if (solver == NodeSolver::Auto) {
+                solver = (n >= GolubWelschMinNodes) ? NodeSolver::GolubWelsch : NodeSolver::Newton;
+            }
 
-            int count = 0;
-            int max_iter = 100;
+            // initial guess
+            if (solver == NodeSolver::GolubWelsch) {
+                // Jacobi matrix of the Legendre polynomials
+                vec_t e(n);
+                x = 0.0;
+                for (size_t k = 1; k < n; k++) {
+                    e[k-1] = k / std::sqrt(4.0 * k * k - 1.0);
+                }
+                tridiagonal_eigenvalues(x, e);
+            } else {
+                Chebyshev2 Cheb2Q(n);
+                x = Cheb2Q.x;
+            }
 
-            while ( x_diff.Linf_norm() > 1e-10 || count < max_iter) {
-                x_prev = x;
-                for (size_t i = 0; i < n; i++) {
-                    x[i] = x_prev[i] - Legendre::poly(x_prev[i], n) / Legendre::d_poly(x_prev[i], n);
+            // Newton-Raphson, each node until converged
+            for (size_t i = 0; i < n; i++) {
+                for (size_t iter = 0; iter < max_iter; iter++) {
+                    Legendre::Value L = Legendre::eval(x[i], n);
+                    scalar_t dx = L.p / L.dp;
+                    x[i] -= dx;
+                    if (std::abs(dx) <= tol) break;
                 }
-                x_diff = x - x_prev;
-                count++;
             }
 
             // compute weights
             for (size_t i = 0; i < n; i++) {
-                w[i] = 2.0 / ((1.0 - x[i] * x[i]) * Legendre::d_poly(x[i], n) * Legendre::d_poly(x[i], n));
+                scalar_t dp = Legendre::eval(x[i], n).dp;
+                w[i] = 2.0 / ((1.0 - x[i] * x[i]) * dp * dp);
             }
         }
 
@@ -117,37 +242,52 @@ namespace DG::core{
      */
     class Lobatto : public Quadrature{
     public:
-        Lobatto(size_t n) : Quadrature(n) {
+        // interior points are the roots of P_{n-1}'
+        Lobatto(size_t n, NodeSolver solver = NodeSolver::Auto, scalar_t tol = 1e-15, size_t max_iter = 100) : Quadrature(n) {
+            if (solver == NodeSolver::Auto) {
+                solver = (n >= GolubWelschMinNodes) ? NodeSolver::GolubWelsch : NodeSolver::Newton;
+            }
+
             // initial guess
-            Chebyshev2 Cheb2Q(n-2);
-            for (size_t i = 1; i < n - 1; i++) {
-                x[i] = Cheb2Q.x[i-1];
+            if (solver == NodeSolver::GolubWelsch) {
+                // Jacobi matrix of the Jacobi polynomials P^(1,1), whose roots are the roots of P_{n-1}'
+                size_t m = n - 2;
+                vec_t d(m), e(m);
+                d = 0.0;
+                for (size_t k = 1; k < m; k++) {
+                    e[k-1] = std::sqrt(k * (k + 2.0) / ((2.0 * k + 1.0) * (2.0 * k + 3.0)));
+                }
+                tridiagonal_eigenvalues(d, e);
+                for (size_t i = 1; i < n - 1; i++) {
+                    x[i] = d[i-1];
+                }
+            } else {
+                Chebyshev2 Cheb2Q(n-2);
+                for (size_t i = 1; i < n - 1; i++) {
+                    x[i] = Cheb2Q.x[i-1];
+                }
             }
             x[0] = -1;
             x[n-1] = 1;
 
-            vec_t x_prev(n);
-            x_prev = 2.0;
-            vec_t x_diff = x - x_prev;
-
-            int count = 0;
-            int max_iter = 100;
-
-            while ( x_diff.Linf_norm() > 1e-10 || count < max_iter) {
-                x_prev = x;
-                for (size_t i = 1; i < n - 1; i++) {
-                    x[i] = x_prev[i] - Legendre::d_poly(x_prev[i], n-1) / Legendre::d2_poly(x_prev[i], n-1);
+            // Newton-Raphson, each node until converged
+            for (size_t i = 1; i < n - 1; i++) {
+                for (size_t iter = 0; iter < max_iter; iter++) {
+                    Legendre::Value L = Legendre::eval(x[i], n-1);
+                    scalar_t dx = L.dp / L.d2p;
+                    x[i] -= dx;
+                    if (std::abs(dx) <= tol) break;
                 }
-                x_diff = x - x_prev;
-                count++;
             }
 
             // compute weights
             for (size_t i = 0; i < n; i++) {
                 if (i==0 || i==n-1)
                     w[i] = 2.0 / (n * (n - 1));
-                else
-                    w[i] = 2.0 / (n * (n - 1) * Legendre::poly(x[i], n-1) * Legendre::poly(x[i], n-1));
+                else {
+                    scalar_t p = Legendre::eval(x[i], n-1).p;
+                    w[i] = 2.0 / (n * (n - 1) * p * p);
+                }
             }
         }
 
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "types.hpp"
+
+namespace DG::core::execution {
+    /**
+     * @brief Chase-Lev work-stealing deque of task ids
+     *
+     * The owner pushes and pops at the bottom, thieves steal from the top; the fences of the
+     * original algorithm are replaced by sequentially consistent accesses. The indices only
+     * grow, so the deque never has to be reset between loops; the ring buffer must hold the
+     * largest number of tasks pushed in one loop.
+     */
+    class ChaseLevDeque {
+    private:
+
+        std::vector<std::atomic<size_t>> buf;
+        size_t mask = 0;
+        alignas(64) std::atomic<long> top{0};
+        alignas(64) std::atomic<long> bottom{0};
+
+    public:
+        explicit ChaseLevDeque(size_t capacity = 64) {
+            reserve(capacity);
+        }
+
+        // not thread safe, the deque must be empty
+        void reserve(size_t capacity) {
+            size_t n = 1;
+            while (n < capacity) n *= 2;
+            buf = std::vector<std::atomic<size_t>>(n);
+            mask = n - 1;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+        // owner only
+        void push(size_t x) {
+            long b = bottom.load(std::memory_order_relaxed);
+            buf[b & mask].store(x, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // owner only
+        bool pop(size_t &x) {
+            long b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_seq_cst);
+            long t = top.load(std::memory_order_seq_cst);
+
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            x = buf[b & mask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // last element, race against the thieves
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // any thread
+        bool steal(size_t &x) {
+            long t = top.load(std::memory_order_seq_cst);
+            long b = bottom.load(std::memory_order_seq_cst);
+
+            if (t >= b) return false;
+            x = buf[t & mask].load(std::memory_order_relaxed);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+    };
+
+    /* tasks per thread of a work-stealing loop */
+    inline constexpr size_t TasksPerThread = 8;
+
+    /**
+     * @brief split [0, n) into `ntasks` contiguous ranges of about equal cost
+     *
+     * bounds[k] ... bounds[k+1] is task k; without costs (or all zero) the ranges are even.
+     */
+    inline void balanced_split(size_t n, size_t ntasks, const scalar_t *cost, std::vector<size_t> &bounds) {
+        bounds.assign(ntasks + 1, n);
+        bounds[0] = 0;
+
+        scalar_t total = 0.0;
+        if (cost) {
+            for (size_t i = 0; i < n; i++) total += cost[i];
+        }
+        if (total <= 0.0) {
+            for (size_t k = 1; k < ntasks; k++) bounds[k] = n * k / ntasks;
+            return;
+        }
+
+        scalar_t sum = 0.0;
+        size_t k = 1;
+        for (size_t i = 0; i < n && k < ntasks; i++) {
+            sum += cost[i];
+            while (k < ntasks && sum >= total * k / ntasks) {
+                bounds[k++] = i + 1;
+            }
+        }
+    }
+
+    /**
+     * @brief work-stealing scheduler for the threads of a pool
+     *
+     * Every loop is split into cost-balanced tasks, thread t starts with the t-th contiguous
+     * block of tasks in its own deque and steals from the others when it runs dry. The loop
+     * ends when the (monotonic) counter of completed tasks reaches the task count of the loop;
+     * the caller synchronizes the threads afterwards.
+     */
+    class WorkStealing {
+    private:
+
+        struct alignas(64) Worker {
+            ChaseLevDeque deque;
+            size_t done = 0;    // tasks completed by all loops this thread took part in
+            std::vector<size_t> bounds;
+        };
+
+        std::vector<Worker> workers;
+        alignas(64) std::atomic<size_t> completed{0};
+
+    public:
+        explicit WorkStealing(size_t threads) : workers(threads) {
+            for (auto &w : workers) {
+                w.deque.reserve(TasksPerThread * threads);
+            }
+        }
+
+        size_t size() const {
+            return workers.size();
+        }
+
+        // f(begin, end) on the tasks of [0, n), called by every thread with its rank
+        template<typename F>
+        void run(size_t rank, size_t n, const scalar_t *cost, F &&f) {
+            const size_t T = workers.size();
+            Worker &self = workers[rank];
+
+            const size_t ntasks = std::min(n, TasksPerThread * T);
+            balanced_split(n, ntasks, cost, self.bounds);
+
+            // own block of tasks, pushed in reverse so that pop returns them in order
+            const size_t k0 = ntasks * rank / T;
+            const size_t k1 = ntasks * (rank + 1) / T;
+            for (size_t k = k1; k-- > k0;) {
+                self.deque.push(k);
+            }
+
+            const size_t target = self.done + ntasks;
+            size_t victim = rank;
+            while (true) {
+                size_t k;
+                bool found = self.deque.pop(k);
+                for (size_t v = 1; !found && v < T; v++) {
+                    victim = (victim + 1) % T;
+                    if (victim != rank) found = workers[victim].deque.steal(k);
+                }
+
+                if (found) {
+                    f(self.bounds[k], self.bounds[k + 1]);
+                    completed.fetch_add(1, std::memory_order_acq_rel);
+                } else if (completed.load(std::memory_order_acquire) >= target) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            self.done = target;
+        }
+    };
+
+    /**
+     * @brief per-cell cost estimates for load balancing
+     *
+     * Timings are recorded per task (spread evenly over its cells) and folded into the cost by
+     * an exponential moving average in `commit`. The costs can also be set directly, e.g. from
+     * the polynomial order of every cell.
+     */
+    class CostModel {
+    private:
+
+        std::vector<scalar_t> sample;
+
+    public:
+        std::vector<scalar_t> cost;     // zero: not measured yet
+        scalar_t alpha = 0.25;          // weight of a new sample
+
+        CostModel(size_t n = 0) : sample(n, 0.0), cost(n, 0.0) {}
+
+        // measured run time of the cells [begin, end)
+        void record(size_t begin, size_t end, scalar_t seconds) {
+            for (size_t i = begin; i < end; i++) {
+                sample[i] = seconds / (end - begin);
+            }
+        }
+
+        // fold the samples of the cells [begin, end) into the costs
+        void commit(size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                cost[i] = (cost[i] > 0.0) ? (1.0 - alpha) * cost[i] + alpha * sample[i] : sample[i];
+            }
+        }
+
+        const scalar_t* data() const {
+            return cost.data();
+        }
+    };
+}
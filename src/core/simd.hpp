@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/*
+    SIMD abstraction: std::experimental::simd when available, a one-lane scalar fallback otherwise.
+    The vector width follows the target flags (SSE2 by default, AVX2 / AVX-512 with DG_NATIVE_ARCH).
+    Define DG_NO_SIMD to force the scalar path.
+*/
+#if !defined(DG_NO_SIMD) && __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define DG_HAS_SIMD 1
+#else
+#define DG_HAS_SIMD 0
+#endif
+
+namespace DG::core::simd {
+
+#if DG_HAS_SIMD
+    namespace stdx = std::experimental;
+
+    template<typename T>
+    using pack = stdx::native_simd<T>;
+
+    template<typename T>
+    inline pack<T> load(const T *ptr) {
+        return pack<T>(ptr, stdx::element_aligned);
+    }
+
+    template<typename T>
+    inline void store(const pack<T> &v, T *ptr) {
+        v.copy_to(ptr, stdx::element_aligned);
+    }
+
+    template<typename T> inline pack<T> sqrt(const pack<T> &a) { return stdx::sqrt(a); }
+    template<typename T> inline pack<T> abs(const pack<T> &a) { return stdx::abs(a); }
+    template<typename T> inline pack<T> min(const pack<T> &a, const pack<T> &b) { return stdx::min(a, b); }
+    template<typename T> inline pack<T> max(const pack<T> &a, const pack<T> &b) { return stdx::max(a, b); }
+
+    /* lane-wise mask ? a : b */
+    template<typename T>
+    inline pack<T> select(const typename pack<T>::mask_type &mask, const pack<T> &a, const pack<T> &b) {
+        pack<T> r = b;
+        stdx::where(mask, r) = a;
+        return r;
+    }
+#else
+    /**
+     * @brief one-lane stand-in for a SIMD register
+     */
+    template<typename T>
+    struct pack {
+        T v;
+
+        pack() = default;
+        pack(T v) : v(v) {}
+
+        static constexpr size_t size() { return 1; }
+
+        friend pack operator+(pack a, pack b) { return a.v + b.v; }
+        friend pack operator-(pack a, pack b) { return a.v - b.v; }
+        friend pack operator*(pack a, pack b) { return a.v * b.v; }
+        friend pack operator/(pack a, pack b) { return a.v / b.v; }
+        friend pack operator-(pack a) { return -a.v; }
+        pack& operator+=(pack b) { v += b.v; return *this; }
+
+        friend bool operator<(pack a, pack b) { return a.v < b.v; }
+        friend bool operator>(pack a, pack b) { return a.v > b.v; }
+        friend bool operator<=(pack a, pack b) { return a.v <= b.v; }
+        friend bool operator>=(pack a, pack b) { return a.v >= b.v; }
+    };
+
+    template<typename T>
+    inline pack<T> load(const T *ptr) {
+        return pack<T>(*ptr);
+    }
+
+    template<typename T>
+    inline void store(const pack<T> &v, T *ptr) {
+        *ptr = v.v;
+    }
+
+    template<typename T> inline pack<T> sqrt(const pack<T> &a) { return std::sqrt(a.v); }
+    template<typename T> inline pack<T> abs(const pack<T> &a) { return std::abs(a.v); }
+    template<typename T> inline pack<T> min(const pack<T> &a, const pack<T> &b) { return std::min(a.v, b.v); }
+    template<typename T> inline pack<T> max(const pack<T> &a, const pack<T> &b) { return std::max(a.v, b.v); }
+
+    template<typename T>
+    inline pack<T> select(bool mask, const pack<T> &a, const pack<T> &b) {
+        return mask ? a : b;
+    }
+#endif
+
+    /*
+        the same functions for plain scalars, so that kernels templated on scalar_t or a pack
+        can call simd::sqrt etc. for both
+    */
+    inline double sqrt(double a) { return std::sqrt(a); }
+    inline double abs(double a) { return std::abs(a); }
+    inline double min(double a, double b) { return std::min(a, b); }
+    inline double max(double a, double b) { return std::max(a, b); }
+    inline double select(bool mask, double a, double b) { return mask ? a : b; }
+
+    /* number of lanes of a pack of T */
+    template<typename T>
+    inline constexpr size_t width = pack<T>::size();
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <numbers>
+#include "quadrature.hpp"
+#include "types.hpp"
+
+namespace DG::core {
+
+    /* constexpr math helpers used to build the tables at compile time */
+    namespace cx {
+        constexpr scalar_t abs(scalar_t x) {
+            return x < 0 ? -x : x;
+        }
+
+        constexpr scalar_t sqrt(scalar_t x) {
+            if (x <= 0) return 0.0;
+            scalar_t r = x < 1 ? 1.0 : x;
+            for (size_t i = 0; i < 200; i++) {
+                scalar_t next = 0.5 * (r + x / r);
+                if (next == r) break;
+                r = next;
+            }
+            return r;
+        }
+
+        // cos(x) for x in [0, pi], Taylor series around pi/2
+        constexpr scalar_t cos(scalar_t x) {
+            scalar_t t = std::numbers::pi / 2 - x;   // cos(x) = sin(t), |t| <= pi/2
+            scalar_t term = t, sum = t;
+            for (size_t k = 1; k < 30; k++) {
+                term *= -t * t / ((2 * k) * (2 * k + 1));
+                sum += term;
+            }
+            return sum;
+        }
+    }
+
+    /*
+        node counts with compile-time reference tables: porder = 1 ... 16. RefCell loads them for
+        every order, the compile-time sized cells (integrator::MaxFixedNodes) only use the lower ones
+    */
+    inline constexpr size_t MinTableNodes = 2;
+    inline constexpr size_t MaxTableNodes = 17;
+
+    /**
+     *  @brief compile-time operators of the reference cell with N Gauss-Lobatto nodes
+     *
+     *  Same quantities as `RefCell`, evaluated in closed form (no matrix inverse):
+     *  D from the Lagrange derivative at Lobatto nodes, Minv = V V^T from the Legendre
+     *  recurrence, lift vectors are the first and last columns of Minv B.
+     *  Matrices are row-major N x N.
+     */
+    template<const size_t N>
+    struct RefTable {
+        static_assert(N >= MinTableNodes, "At least two nodes are required.");
+
+        std::array<scalar_t, N> x{};        // Coordinates of quadrature points
+        std::array<scalar_t, N> w{};        // Weights of quadrature points
+        std::array<scalar_t, N * N> D{};    // Differentiation matrix
+        std::array<scalar_t, N * N> Minv{}; // Inverse of mass matrix
+        std::array<scalar_t, N> lift_L{};   // Lift vectors
+        std::array<scalar_t, N> lift_R{};
+
+        static constexpr RefTable build() {
+            RefTable T;
+            constexpr size_t n = N - 1;     // polynomial order
+
+            // Lobatto nodes: roots of P_n', Newton from Chebyshev initial guesses
+            T.x[0] = -1.0;
+            T.x[N-1] = 1.0;
+            for (size_t i = 1; i < N - 1; i++) {
+                scalar_t xi = -cx::cos(std::numbers::pi * (4 * (i - 1) + 3) / (4 * (N - 2) + 2));
+                for (size_t iter = 0; iter < 100; iter++) {
+                    Legendre::Value L = Legendre::eval(xi, n);
+                    scalar_t dx = L.dp / L.d2p;
+                    xi -= dx;
+                    if (cx::abs(dx) <= 1e-15) break;
+                }
+                T.x[i] = xi;
+            }
+
+            // weights and P_n at the nodes
+            std::array<scalar_t, N> Pn{};
+            for (size_t i = 0; i < N; i++) {
+                Pn[i] = Legendre::eval(T.x[i], n).p;
+                T.w[i] = 2.0 / (N * n * Pn[i] * Pn[i]);
+            }
+
+            // differentiation matrix of the Lagrange basis at the Lobatto nodes
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    if (i != j) T.D[i * N + j] = Pn[i] / Pn[j] / (T.x[i] - T.x[j]);
+                }
+            }
+            T.D[0] = -0.25 * N * n;
+            T.D[N * N - 1] = 0.25 * N * n;
+
+            // inverse mass matrix: V V^T with the orthonormal Legendre Vandermonde matrix
+            std::array<scalar_t, N * N> V{};
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    V[i * N + j] = cx::sqrt(0.5 * (2.0 * j + 1.0)) * Legendre::eval(T.x[i], j).p;
+                }
+            }
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    scalar_t sum = 0.0;
+                    for (size_t k = 0; k < N; k++) {
+                        sum += V[i * N + k] * V[j * N + k];
+                    }
+                    T.Minv[i * N + j] = sum;
+                }
+            }
+
+            // B = diag(-1, 0, ..., 0, 1)
+            for (size_t i = 0; i < N; i++) {
+                T.lift_L[i] = -T.Minv[i * N];
+                T.lift_R[i] =  T.Minv[i * N + N - 1];
+            }
+
+            return T;
+        }
+    };
+
+    template<const size_t N>
+    inline constexpr RefTable<N> ref_table = RefTable<N>::build();
+}
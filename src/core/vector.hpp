@@ -1,29 +1,48 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
+#include "allocator.hpp"
+#include "expression.hpp"
 
 namespace DG::core{
     /** 
      * @brief data type: vector
      * 
-     * wraps around a std::vector to provide vector operations in linear algebra
+     * wraps around a std::vector to provide vector operations in linear algebra;
+     * arithmetic operators build lazy expressions (see expression.hpp)
      */
-    template<typename T>
-    class vec {
+    template<typename T, typename Alloc = std::allocator<T>>
+    class vec : public expression_base {
 
     protected:
 
-        size_t N;               // size
-        std::vector<T> data_;   // elements
+        size_t N = 0;               // size
+        std::vector<T, Alloc> data_;   // elements
 
     public:
+        using value_type = T;
+
         // constructors
         vec() = default;
         vec(std::initializer_list<T> list) : N(list.size()), data_(list) {}
         vec(size_t size) : N(size) {data_.resize(size);}
         vec(const vec& other) : N(other.N), data_(other.data_) {}
+        vec(vec&& other) = default;
+        vec& operator=(const vec& other) = default;
+        vec& operator=(vec&& other) = default;
+
+        // evaluate an expression
+        template<expression_tree E>
+        vec(const E &e) : N(e.size()), data_(e.size()) {
+            for (size_t i = 0; i < N; i++) {
+                data_[i] = e.elem(i);
+            }
+        }
 
         // destructor
         virtual ~vec() = default;
@@ -55,48 +74,47 @@ namespace DG::core{
             return *this;
         }
 
-		vec operator*(const T &scalar) const {
-            vec res = *this;
-			for (size_t i = 0; i < N; i++) {
-				res[i] *= scalar;
-			}
-			return res;
-		}
+        template<expression_tree E>
+        vec& operator=(const E &e) {
+            if (N != e.size()) resize(e.size());
+            for (size_t i = 0; i < N; i++) {
+                data_[i] = e.elem(i);
+            }
+            return *this;
+        }
 
-		vec operator/(const T &scalar) const {
-            vec res = *this;
-			for (size_t i = 0; i < N; i++) {
-				res[i] /= scalar;
-			}
-			return res;
-		}
+        template<expression E>
+        vec& operator+=(const E &e) {
+            assert(N == e.size() && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] += e.elem(i);
+            }
+            return *this;
+        }
+
+        template<expression E>
+        vec& operator-=(const E &e) {
+            assert(N == e.size() && "Size mismatch.");
+            for (size_t i = 0; i < N; i++) {
+                data_[i] -= e.elem(i);
+            }
+            return *this;
+        }
 
 		vec& operator*=(const T &scalar) {
-			*this = (*this * scalar);
+			for (size_t i = 0; i < N; i++) {
+				data_[i] *= scalar;
+			}
 			return *this;
 		}
 
 		vec& operator/=(const T &scalar) {
-			*this = (*this) / scalar;
+			for (size_t i = 0; i < N; i++) {
+				data_[i] /= scalar;
+			}
 			return *this;
 		}
 
-        vec operator+(const vec &other) const {
-            vec result = *this;
-            for (size_t i = 0; i < N; i++) {
-                result[i] = data_[i] + other.data_[i];
-            }
-            return result;
-        }
-
-        vec operator-(const vec &other) const {
-            vec result = *this;
-            for (size_t i = 0; i < N; i++) {
-                result[i] = data_[i] - other.data_[i];
-            }
-            return result;
-        }
-
         T max() const {
             T result = data_[0];
             for (size_t i = 1; i < N; i++) {
@@ -114,18 +132,30 @@ namespace DG::core{
         }
 
         T Linf_norm() const {
-            vec result = *this;
+            T result = 0;
             for (size_t i = 0; i < N; i++) {
-                result[i] = std::abs(data_[i]);
+                result = std::max(result, std::abs(data_[i]));
             }
+            return result;
+        }
 
-            return result.max();
+        // flat element access used by expressions
+        const T& elem(const size_t i) const {
+            return data_[i];
         }
+
+        // raw storage
+        T* data() { return data_.data(); }
+        const T* data() const { return data_.data(); }
     };
 
-    // print vector
+    /* cache line aligned vector, used for large field buffers */
     template<typename T>
-    std::ostream& operator<<(std::ostream& output, const vec<T>& v)
+    using aligned_vec = vec<T, aligned_allocator<T>>;
+
+    // print vector
+    template<typename T, typename Alloc>
+    std::ostream& operator<<(std::ostream& output, const vec<T, Alloc>& v)
     {
         output << "Vector(" << v.size() << "):" << std::endl;
         output << "[";
@@ -2,11 +2,30 @@
 
 #include "core/types.hpp"
 #include <DG.hpp>
+#include <cmath>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
+#include "core/parallel.hpp"
+#include "integrator/steadySolver.hpp"
+#include "integrator/timeSolver.hpp"
 
 namespace DG::driver {
 
+    /**
+     * @brief runs the time loop and writes the output
+     *
+     * With a parallel integrator the whole time loop runs inside one parallel region of its
+     * pool: every thread advances its own cells and the threads only meet at the barriers of
+     * the stages, the dt reduction and the output. The threads are pinned to cores by the
+     * integrator's policy, `execution::parallel_policy{.pin = true}`.
+     *
+     * An adaptive tSolver (`integrator::time::is_adaptive`) picks dt itself, bounded by the CFL
+     * limit of the integrator, and the run stops if it returns 0 (`BDF2` when no step size
+     * converges); a local one (`is_local`) also applies the CFL limit itself.
+     * A steady solver (`integrator::steady::is_steady`) is run by `run_steady` instead.
+     */
     template<typename Integrator, typename tSolver>
     class Driver {
     private:
@@ -15,60 +34,158 @@ namespace DG::driver {
         Integrator integrator;
         tSolver timeSolver;
 
+        // after the first parallel region of the pool
+        void check_pinning() const {
+            if (integrator.pool && !integrator.pool->pinned()) {
+                std::cout << "Warning: rank " << integrator.comm.rank() << " could not pin its threads to cores." << std::endl;
+            }
+        }
+
     public:
 
         Driver(std::string simulation_name, Integrator integrator, tSolver timeSolver) 
-            : simulation_name(simulation_name), integrator(integrator), timeSolver(timeSolver) {}
+            : simulation_name(simulation_name), integrator(integrator), timeSolver(timeSolver) 
+        {}
         
         void run(scalar_t write_interval, scalar_t end_time) {
+            // write initial condition;
+            integrator.update_primitive();
+            check_pinning();
+            write_data(0);
+
+            if (integrator.comm.rank() == 0) {
+                std::cout << "--------------------------------" << std::endl;
+                std::cout << "Simulation starts" << std::endl;
+                std::cout << "--------------------------------" << std::endl;
+            }
+
+            integrator.run_team([&](const execution::Team &team) {
+                time_loop(team, write_interval, end_time);
+            });
+        }
+
+        /*
+            cycles of a steady solver until it converges or reaches its max_cycles; the residual
+            norm is printed every `print_interval` cycles and the history is written to
+            <simulation_name>_residual.csv
+        */
+        void run_steady(size_t print_interval) requires integrator::steady::is_steady<tSolver> {
+            integrator.update_primitive();
+            check_pinning();
+            write_data(0);
+
+            const bool root = (integrator.comm.rank() == 0);
+            if (root) {
+                std::cout << "--------------------------------" << std::endl;
+                std::cout << "Steady state solver starts with " << timeSolver.levels() << " levels" << std::endl;
+                std::cout << "--------------------------------" << std::endl;
+            }
+
+            integrator.run_team([&](const execution::Team &team) {
+                for (size_t k = 0; k < timeSolver.max_cycles; k++) {
+                    scalar_t residual = timeSolver.cycle(integrator, team);
+                    if (team.rank == 0 && root && k % print_interval == 0) {
+                        std::cout << "Cycle " << k << ", residual = " << residual << std::endl;
+                    }
+                    if (timeSolver.converged() || !std::isfinite(residual)) break;
+                }
+            });
+
+            if (root) {
+                // no residual without a cycle (max_cycles = 0)
+                std::cout << (timeSolver.converged() ? "Converged" : "Not converged") << " after " << timeSolver.history.size() << " cycles";
+                if (!timeSolver.history.empty()) std::cout << ", residual = " << timeSolver.history.back();
+                std::cout << std::endl;
+            }
+            integrator.update_primitive();
+            write_data(1);
+
+            if (root) {
+                std::ofstream file(simulation_name + "_residual.csv");
+                file << "cycle,residual" << std::endl;
+                for (size_t k = 0; k < timeSolver.history.size(); k++) {
+                    file << k << "," << timeSolver.history[k] << "\n";
+                }
+            }
+        }
+
+        /*
+            executed by every thread of the team, the loop control is replicated on all threads
+        */
+        void time_loop(const execution::Team &team, scalar_t write_interval, scalar_t end_time) {
             scalar_t time = 0.0;
             scalar_t last_write_time = 0.0;
             size_t count = 0;
 
-            // write initial condition;
-            write_data(count);
+            while(time < end_time) {
+                scalar_t dt = end_time - time;
 
-            std::cout << "--------------------------------" << std::endl;
-            std::cout << "Simulation starts" << std::endl;
-            std::cout << "--------------------------------" << std::endl;
+                if constexpr (integrator::time::is_local<tSolver>) {
+                    // local time stepping applies the CFL condition per cell
+                    dt = timeSolver.step(integrator, dt, team);
+                } else {
+                    dt = integrator.compute_dt_global(team);
+                    if (time + dt > end_time) {
+                        dt = end_time - time;
+                    }
 
-            while(time < end_time) {
-                scalar_t dt = integrator.compute_dt_global();
-                if (time + dt > end_time) {
-                    dt = end_time - time;
+                    // adaptive solvers take the CFL limit as an upper bound of their own dt
+                    if constexpr (integrator::time::is_adaptive<tSolver>) {
+                        dt = timeSolver.step(integrator, dt, team);
+                        if (!(dt > 0.0)) {
+                            // an implicit solver rejected every step size
+                            if (team.rank == 0 && integrator.comm.rank() == 0) {
+                                std::cout << "Time step failed at time = " << time << std::endl;
+                            }
+                            break;
+                        }
+                    } else {
+                        timeSolver.advance(integrator, dt, team);
+                    }
                 }
                 time += dt;
-
-                timeSolver.advance(integrator, dt);
                 
                 // write data
                 if (time - last_write_time >= write_interval || time >= end_time) {
                     count++;
-                    std::cout << "Frame " << count << " at time = " << time << std::endl;
                     last_write_time = time;
-                    write_data(count);
+
+                    integrator.update_primitive(team);
+                    team.sync();
+                    if (team.rank == 0) {
+                        if (integrator.comm.rank() == 0) std::cout << "Frame " << count << " at time = " << time << std::endl;
+                        write_data(count);
+                    }
+                    team.sync();
                 }
             }
         }
 
         // TODO: make it more general
+        // the rows of all ranks are gathered and written by rank 0
         void write_data(size_t count) {
+            std::vector<scalar_t> local, rows;
+            for (size_t i = 0; i < integrator.Ncells; i++) {
+                auto cell = integrator.cell(i);
+                for (size_t j = 0; j < integrator.Nnodes; j++) {
+                    local.insert(local.end(), {cell.x[j][0], cell.p(j, 0), cell.p(j, 1), cell.p(j, 2)});
+                }
+            }
+            integrator.comm.gather(local, rows);
+            if (integrator.comm.rank() != 0) return;
+
             std::ofstream file;
             file.open(simulation_name + "_" + std::to_string(count) + ".csv");
 
-            integrator.update_primitive();
-
             // write header
             file << "x,rho,u,p" << std::endl;
 
-            for (size_t i = 0; i < integrator.Ncells; i++) {
-                for (size_t j = 0; j < integrator.Nnodes; j++) {
-                    file 
-                    << integrator.cells[i].x[j][0] << "," 
-                    << integrator.cells[i].p[j][0] << "," 
-                    << integrator.cells[i].p[j][1] << "," 
-                    << integrator.cells[i].p[j][2] << "\n";
-                }
+            for (size_t r = 0; r < rows.size(); r += 4) {
+                file 
+                << rows[r] << "," 
+                << rows[r + 1] << "," 
+                << rows[r + 2] << "," 
+                << rows[r + 3] << "\n";
             }
 
             file.close();
@@ -2,6 +2,8 @@
 
 #include "core/types.hpp"
 #include <DG.hpp>
+#include <type_traits>
+#include "core/tables.hpp"
 
 namespace DG::integrator{
 
@@ -12,30 +14,51 @@ namespace DG::integrator{
 
     /**
      *  @brief DG cell class
+     *
+     *  A view of one cell in the global `Field` buffers: it owns no solution data, the
+     *  state matrices map the cell's contiguous [node][eqn] block.
+     *
+     *  @param NN number of quadrature nodes; `dynamic` takes the node count at run time
      */
-    template<typename Model>
+    template<typename Model, const size_t NN = dynamic>
     class Cell {
     private:
         static constexpr size_t ND = Model::NumDims;
         static constexpr size_t NE = Model::NumEqns;
-        
+
     public:
+        using view_t  = matrix_view<scalar_t, NN, NE>;
+        using state_t = std::conditional_t<NN == dynamic, mat_t, matrix<scalar_t, NN, NE>>;
+
         scalar_t detJ;
         arr_t<ND> size;
-        vec<arr_t<ND>> x;   // coordinates of the quadrature points
+        const arr_t<ND> *x;     // coordinates of the quadrature points
 
-        mat_t u;
-        mat_t p;
-        mat_t u0;
+        view_t u;
+        view_t p;
+        view_t u0;
+        view_t dudt;
+
+        matrix_view<scalar_t, 2, NE> f_star;    // numerical fluxes at cell boundaries
+    };
 
-        std::array<vec_t, 2> f_star;    // numerical fluxes at cell boundaries
+    /* node counts with a compile-time sized cell: porder = 1 ... 8 */
+    inline constexpr size_t MinFixedNodes = 2;
+    inline constexpr size_t MaxFixedNodes = 9;
+    static_assert(MinFixedNodes >= MinTableNodes && MaxFixedNodes <= MaxTableNodes, "Every fixed node count has a reference table.");
 
-        /*
-            constructor: initialize a cell
-        */
-        Cell(size_t Nnodes) : x(Nnodes), u(Nnodes, NE), p(Nnodes, NE), u0(Nnodes, NE) {
-            f_star[L].resize(NE);
-            f_star[R].resize(NE);
+    /**
+     *  @brief call `f(std::integral_constant<size_t, NN>{})` with the node count of `porder`
+     *
+     *  Orders without a fixed size instantiation fall back to `NN = dynamic`.
+     */
+    template<size_t NN = MinFixedNodes>
+    decltype(auto) dispatch_porder(size_t porder, auto &&f) {
+        if constexpr (NN > MaxFixedNodes) {
+            return f(std::integral_constant<size_t, dynamic>{});
+        } else {
+            if (porder + 1 == NN) return f(std::integral_constant<size_t, NN>{});
+            return dispatch_porder<NN + 1>(porder, f);
         }
-    };
-}
\ No newline at end of file
+    }
+}
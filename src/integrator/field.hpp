@@ -0,0 +1,131 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <DG.hpp>
+#include <cstddef>
+#include <vector>
+#include "cell.hpp"
+
+namespace DG::integrator {
+
+    /* registers of the field that only some solvers use, allocated on first use */
+    struct Registers {
+        static constexpr unsigned DUDT   = 1;   // dudt
+        static constexpr unsigned VOLUME = 2;   // F and DF
+        static constexpr unsigned U0     = 4;   // u0
+        static constexpr unsigned RHS    = DUDT | VOLUME;   // the unfused right hand side
+    };
+
+    /**
+     *  @brief global solution storage
+     *
+     *  Each register is one aligned contiguous block indexed [cell][node][eqn], so whole-field
+     *  operations (RK stage copies and combinations) are single streaming loops. `cell(i)`
+     *  returns a `Cell` view of the i-th block.
+     *
+     *  u, p and the flux registers always exist (p is read by the time step and the output);
+     *  u0, dudt, F and DF are only allocated by `reserve`, so the fused stage kernel of the
+     *  explicit solvers never holds F, DF and dudt, and LS_RK4 keeps two registers, u and dudt.
+     */
+    template<typename Model, const size_t NN = dynamic>
+    class Field {
+    private:
+        static constexpr size_t ND = Model::NumDims;
+        static constexpr size_t NE = Model::NumEqns;
+
+    public:
+        using cell_t = Cell<Model, NN>;
+
+        size_t Ncells;
+        size_t Nnodes;
+        size_t Nfaces;
+
+        using buffer_t = aligned_vec<scalar_t>;
+
+        buffer_t u;         // conserved variables
+        buffer_t p;         // primitive variables
+        buffer_t u0;        // conserved variables at the beginning of a time step
+        buffer_t dudt;      // right hand side
+        buffer_t F;         // physical flux at the quadrature points, node-major [node][cell][eqn]
+        buffer_t DF;        // differentiated physical flux, node-major
+        buffer_t f_star;    // numerical fluxes at the cell boundaries, [cell][L/R][eqn]
+        buffer_t f_face;    // numerical fluxes at the faces, [face][eqn]
+
+        std::vector<buffer_t> scratch;  // per thread, cell packets of the fused stage kernel
+
+        // interior faces: traces of both sides and numerical fluxes, [eqn][face] (SoA)
+        size_t Ntraces = 0;
+        buffer_t trace_minus, trace_plus, f_trace;
+
+        std::vector<arr_t<ND>> x;       // coordinates of the quadrature points, [cell][node]
+        std::vector<arr_t<ND>> size;    // cell sizes
+        std::vector<scalar_t> detJ;     // determinants of the cell mappings
+
+        Field(size_t Ncells, size_t Nnodes, size_t Nfaces = 0)
+            : Ncells(Ncells), Nnodes(Nnodes), Nfaces(Nfaces), u(Ncells * Nnodes * NE), p(Ncells * Nnodes * NE),
+              f_star(Ncells * 2 * NE), f_face(Nfaces * NE), x(Ncells * Nnodes), size(Ncells), detJ(Ncells)
+        {
+            assert((NN == dynamic || NN == Nnodes) && "Node count mismatch.");
+            u = 0.0; p = 0.0; f_star = 0.0; f_face = 0.0;
+        }
+
+        // allocate the registers of the mask that do not exist yet, not thread safe
+        void reserve(unsigned registers) {
+            const size_t n = Ncells * Nnodes * NE;
+            if ((registers & Registers::DUDT) && dudt.size() != n) {
+                dudt.resize(n);
+                dudt = 0.0;
+            }
+            if ((registers & Registers::VOLUME) && F.size() != n) {
+                F.resize(n);
+                DF.resize(n);
+                F = 0.0; DF = 0.0;
+            }
+            if ((registers & Registers::U0) && u0.size() != n) {
+                u0.resize(n);
+                u0 = 0.0;
+            }
+        }
+
+        bool reserved(unsigned registers) const {
+            const size_t n = Ncells * Nnodes * NE;
+            if ((registers & Registers::DUDT) && dudt.size() != n) return false;
+            if ((registers & Registers::VOLUME) && F.size() != n) return false;
+            if ((registers & Registers::U0) && u0.size() != n) return false;
+            return true;
+        }
+
+        // n values of scratch for each of the threads
+        void resize_scratch(size_t threads, size_t n) {
+            scratch.assign(threads, buffer_t(n));
+        }
+
+        // trace buffers of n interior faces
+        void resize_traces(size_t n) {
+            Ntraces = n;
+            trace_minus.resize(n * NE);
+            trace_plus.resize(n * NE);
+            f_trace.resize(n * NE);
+            trace_minus = 0.0; trace_plus = 0.0; f_trace = 0.0;
+        }
+
+        // number of values per cell in a state register
+        size_t stride() const {
+            return Nnodes * NE;
+        }
+
+        // view of the i-th cell, the registers that are not allocated have null views
+        cell_t cell(const size_t i) {
+            size_t offset = i * stride();
+            auto block = [&](buffer_t &r) { return r.size() ? r.data() + offset : nullptr; };
+            return cell_t{
+                detJ[i], size[i], &x[i * Nnodes],
+                {u.data() + offset, Nnodes},
+                {p.data() + offset, Nnodes},
+                {block(u0), Nnodes},
+                {block(dudt), Nnodes},
+                {f_star.data() + i * 2 * NE}
+            };
+        }
+    };
+}
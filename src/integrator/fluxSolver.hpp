@@ -1,31 +1,255 @@
 #pragma once
 
 #include <DG.hpp>
+#include <array>
 #include <cstddef>
+#include "core/simd.hpp"
 
 namespace DG::integrator::flux {
 
+    /*
+        numerical flux for a batch of n faces in SoA layout: u_minus[k * ld + i] is equation k
+        of the trace on the - side of face i, same for u_plus and f. kernel(u_minus, u_plus, f)
+        is called with std::arrays of simd::packs and, for the remainder, of scalar_t
+    */
+    template<size_t NE, typename Kernel>
+    void batch(const scalar_t *u_minus, const scalar_t *u_plus, scalar_t *f, const size_t n, const size_t ld, Kernel &&kernel) {
+        using pack_t = simd::pack<scalar_t>;
+        constexpr size_t W = simd::width<scalar_t>;
+
+        size_t i = 0;
+        for (; i + W <= n; i += W) {
+            std::array<pack_t, NE> um, up, fb;
+            for (size_t k = 0; k < NE; k++) {
+                um[k] = simd::load(u_minus + k * ld + i);
+                up[k] = simd::load(u_plus + k * ld + i);
+            }
+            kernel(um, up, fb);
+            for (size_t k = 0; k < NE; k++) {
+                simd::store(fb[k], f + k * ld + i);
+            }
+        }
+
+        // remainder
+        for (; i < n; i++) {
+            std::array<scalar_t, NE> um, up, fb;
+            for (size_t k = 0; k < NE; k++) {
+                um[k] = u_minus[k * ld + i];
+                up[k] = u_plus[k * ld + i];
+            }
+            kernel(um, up, fb);
+            for (size_t k = 0; k < NE; k++) {
+                f[k * ld + i] = fb[k];
+            }
+        }
+    }
+
+    /* single face through the kernel of a batched flux, so both give the same bits */
+    template<typename var_t, size_t NE, typename Kernel>
+    var_t single(const var_t &u_minus, const var_t &u_plus, Kernel &&kernel) {
+        std::array<scalar_t, NE> um, up, fb;
+        for (size_t k = 0; k < NE; k++) {
+            um[k] = u_minus[k];
+            up[k] = u_plus[k];
+        }
+        kernel(um, up, fb);
+
+        var_t f;
+        for (size_t k = 0; k < NE; k++) {
+            f[k] = fb[k];
+        }
+        return f;
+    }
+
     template<typename Model>
     class LaxFriedrichs {
 
+        using var_t = typename Model::var_t;
+        using jac_t = typename Model::jac_t;
+
+        static constexpr size_t NE = Model::NumEqns;
         static constexpr scalar_t a = 0.0;
 
+        template<typename V>
+        static V pressure(const std::array<V, NE> &u) {
+            V ke = 0.0;
+            for (size_t i = 0; i < Model::NumDims; ++i) {
+                ke += 0.5 * u[1 + i] * u[1 + i];
+            }
+            return (Model::gamma - 1) * (u[Model::ip] - ke / u[0]);
+        }
+
     public:
-        static vec_t flux(const vec_t &u_minus, const vec_t &u_plus, const size_t dim) {
+        static var_t flux(const var_t &u_minus, const var_t &u_plus, const size_t dim) {
             scalar_t lambda_l = Model::max_wave_speed(u_minus, dim);
             scalar_t lambda_r = Model::max_wave_speed(u_plus, dim);
             scalar_t alpha = std::max(lambda_l, lambda_r);
 
-            vec_t flux = (Model::Fu(u_minus, dim) + Model::Fu(u_plus, dim)) * 0.5 - (u_plus - u_minus) * 0.5 * alpha * (1.0 - a);
+            var_t flux = (Model::Fu(u_minus, dim) + Model::Fu(u_plus, dim)) * 0.5 - (u_plus - u_minus) * 0.5 * alpha * (1.0 - a);
             return flux;
         }
+
+        /*
+            batched flux, see `flux::batch`; Euler only, same operations as `flux`
+        */
+        static void flux_batch(const scalar_t *u_minus, const scalar_t *u_plus, scalar_t *f, const size_t n, const size_t ld, const size_t dim) {
+            batch<NE>(u_minus, u_plus, f, n, ld, [dim](const auto &um, const auto &up, auto &fb) { kernel(um, up, fb, dim); });
+        }
+
+        template<typename V>
+        static void kernel(const std::array<V, NE> &u_minus, const std::array<V, NE> &u_plus, std::array<V, NE> &f, const size_t dim) {
+            // max_wave_speed of the traces
+            V lambda_l = u_minus[1 + dim] + simd::sqrt(Model::gamma * pressure(u_minus) / u_minus[0]);
+            V lambda_r = u_plus[1 + dim] + simd::sqrt(Model::gamma * pressure(u_plus) / u_plus[0]);
+            V alpha = simd::max(lambda_l, lambda_r);
+
+            std::array<V, NE> F_minus, F_plus;
+            Model::flux_kernel(u_minus, F_minus, dim);
+            Model::flux_kernel(u_plus, F_plus, dim);
+            for (size_t k = 0; k < NE; k++) {
+                f[k] = (F_minus[k] + F_plus[k]) * 0.5 - (u_plus[k] - u_minus[k]) * 0.5 * alpha * (1.0 - a);
+            }
+        }
+
+        /*
+            Jacobians of the flux with respect to u_minus and u_plus, with the dissipation
+            coefficient alpha frozen at its value for the given traces (its derivative is
+            discontinuous where the max switches sides)
+        */
+        static void flux_jacobian(const var_t &u_minus, const var_t &u_plus, const size_t dim, jac_t &J_minus, jac_t &J_plus) {
+            scalar_t lambda_l = Model::max_wave_speed(u_minus, dim);
+            scalar_t lambda_r = Model::max_wave_speed(u_plus, dim);
+            scalar_t alpha = std::max(lambda_l, lambda_r);
+
+            J_minus = Model::dFdu(u_minus, dim) * 0.5;
+            J_plus  = Model::dFdu(u_plus, dim) * 0.5;
+            for (size_t k = 0; k < Model::NumEqns; k++) {
+                J_minus(k, k) += 0.5 * alpha * (1.0 - a);
+                J_plus(k, k)  -= 0.5 * alpha * (1.0 - a);
+            }
+        }
+    };
+
+    /*
+        states of the two traces of a face used by the approximate Riemann solvers of the Euler
+        equations: primitive variables, total enthalpy and the Roe averages
+    */
+    template<typename Model, typename V>
+    struct RoeState {
+        static constexpr size_t ND = Model::NumDims;
+        static constexpr size_t NE = Model::NumEqns;
+        static constexpr size_t ip = Model::ip;
+        static constexpr scalar_t gamma = Model::gamma;
+
+        V rho_l, rho_r, p_l, p_r, H_l, H_r;
+        std::array<V, ND> v_l, v_r;
+        V rho, H, q2, c;            // Roe averages, q2 = |v|^2
+        std::array<V, ND> v;
+
+        RoeState(const std::array<V, NE> &u_l, const std::array<V, NE> &u_r) {
+            rho_l = u_l[0];
+            rho_r = u_r[0];
+            V ke_l = 0.0, ke_r = 0.0;
+            for (size_t i = 0; i < ND; ++i) {
+                v_l[i] = u_l[1 + i] / rho_l;
+                v_r[i] = u_r[1 + i] / rho_r;
+                ke_l += 0.5 * u_l[1 + i] * u_l[1 + i];
+                ke_r += 0.5 * u_r[1 + i] * u_r[1 + i];
+            }
+            p_l = (gamma - 1) * (u_l[ip] - ke_l / rho_l);
+            p_r = (gamma - 1) * (u_r[ip] - ke_r / rho_r);
+            H_l = (u_l[ip] + p_l) / rho_l;
+            H_r = (u_r[ip] + p_r) / rho_r;
+
+            V s_l = simd::sqrt(rho_l);
+            V s_r = simd::sqrt(rho_r);
+            V w_l = s_l / (s_l + s_r);
+            V w_r = s_r / (s_l + s_r);
+            rho = s_l * s_r;
+            H = w_l * H_l + w_r * H_r;
+            q2 = 0.0;
+            for (size_t i = 0; i < ND; ++i) {
+                v[i] = w_l * v_l[i] + w_r * v_r[i];
+                q2 += v[i] * v[i];
+            }
+            c = simd::sqrt((gamma - 1) * (H - 0.5 * q2));
+        }
     };
 
+    /**
+     * @brief HLLC approximate Riemann solver of the Euler equations
+     *
+     * Restores the contact wave of HLL (Toro, Riemann Solvers and Numerical Methods, ch. 10),
+     * the outer wave speeds are the estimates of Einfeldt from the traces and the Roe averages.
+     * The four candidate fluxes are evaluated for every face and the one of the star region
+     * containing x/t = 0 is selected, so the batched kernel has no branches.
+     */
     template<typename Model>
     class HLLC {
 
+        using var_t = typename Model::var_t;
+
+        static constexpr size_t ND = Model::NumDims;
+        static constexpr size_t NE = Model::NumEqns;
+        static constexpr size_t ip = Model::ip;
+
     public:
+        static var_t flux(const var_t &u_minus, const var_t &u_plus, const size_t dim) {
+            return single<var_t, NE>(u_minus, u_plus, [dim](const auto &um, const auto &up, auto &fb) { kernel(um, up, fb, dim); });
+        }
+
+        /*
+            batched flux, see `flux::batch`
+        */
+        static void flux_batch(const scalar_t *u_minus, const scalar_t *u_plus, scalar_t *f, const size_t n, const size_t ld, const size_t dim) {
+            batch<NE>(u_minus, u_plus, f, n, ld, [dim](const auto &um, const auto &up, auto &fb) { kernel(um, up, fb, dim); });
+        }
+
+        template<typename V>
+        static void kernel(const std::array<V, NE> &u_l, const std::array<V, NE> &u_r, std::array<V, NE> &f, const size_t dim) {
+            const size_t in = 1 + dim;
+            RoeState<Model, V> s(u_l, u_r);
+
+            V un_l = s.v_l[dim];
+            V un_r = s.v_r[dim];
+            V c_l = simd::sqrt(Model::gamma * s.p_l / s.rho_l);
+            V c_r = simd::sqrt(Model::gamma * s.p_r / s.rho_r);
 
+            // wave speeds
+            V S_l = simd::min(un_l - c_l, s.v[dim] - s.c);
+            V S_r = simd::max(un_r + c_r, s.v[dim] + s.c);
+            V m_l = s.rho_l * (S_l - un_l);
+            V m_r = s.rho_r * (S_r - un_r);
+            V S_star = (s.p_r - s.p_l + m_l * un_l - m_r * un_r) / (m_l - m_r);
+
+            std::array<V, NE> F_l, F_r;
+            Model::flux_kernel(u_l, F_l, dim);
+            Model::flux_kernel(u_r, F_r, dim);
+
+            // star states, U* = coef [1, v with S* as normal component, E/rho + (S* - un)(S* + p/m)]
+            V coef_l = m_l / (S_l - S_star);
+            V coef_r = m_r / (S_r - S_star);
+            std::array<V, NE> Us_l, Us_r;
+            Us_l[0] = coef_l;
+            Us_r[0] = coef_r;
+            for (size_t i = 0; i < ND; ++i) {
+                Us_l[1 + i] = coef_l * s.v_l[i];
+                Us_r[1 + i] = coef_r * s.v_r[i];
+            }
+            Us_l[in] = coef_l * S_star;
+            Us_r[in] = coef_r * S_star;
+            Us_l[ip] = coef_l * (u_l[ip] / s.rho_l + (S_star - un_l) * (S_star + s.p_l / m_l));
+            Us_r[ip] = coef_r * (u_r[ip] / s.rho_r + (S_star - un_r) * (S_star + s.p_r / m_r));
+
+            const V zero = 0.0;
+            for (size_t k = 0; k < NE; k++) {
+                V Fs_l = F_l[k] + S_l * (Us_l[k] - u_l[k]);
+                V Fs_r = F_r[k] + S_r * (Us_r[k] - u_r[k]);
+                f[k] = simd::select(S_l >= zero, F_l[k],
+                       simd::select(S_star >= zero, Fs_l,
+                       simd::select(S_r > zero, Fs_r, F_r[k])));
+            }
+        }
     };
 
     template<typename Model>
@@ -33,8 +257,85 @@ namespace DG::integrator::flux {
         
     };
 
+    /**
+     * @brief Roe approximate Riemann solver of the Euler equations with an entropy fix
+     *
+     * f = (F(u_l) + F(u_r)) / 2 - sum_k |lambda_k| alpha_k r_k / 2 over the eigenvectors r_k of
+     * the Roe matrix: two acoustic waves, the entropy wave and ND - 1 shear waves. The acoustic
+     * eigenvalues are smoothed by Harten's entropy fix, |lambda| < delta is replaced by
+     * (lambda^2 + delta^2) / (2 delta) with delta = entropy_fix * (|v_n| + c) of the Roe
+     * average, which removes the expansion shocks at sonic points.
+     */
     template<typename Model>
     class Roe {
-        
+
+        using var_t = typename Model::var_t;
+
+        static constexpr size_t ND = Model::NumDims;
+        static constexpr size_t NE = Model::NumEqns;
+        static constexpr size_t ip = Model::ip;
+
+        template<typename V>
+        static V harten(const V &lambda, const V &delta) {
+            V abs = simd::abs(lambda);
+            return simd::select(abs < delta, (lambda * lambda + delta * delta) / (2.0 * delta), abs);
+        }
+
+    public:
+        static constexpr scalar_t entropy_fix = 0.1;
+
+        static var_t flux(const var_t &u_minus, const var_t &u_plus, const size_t dim) {
+            return single<var_t, NE>(u_minus, u_plus, [dim](const auto &um, const auto &up, auto &fb) { kernel(um, up, fb, dim); });
+        }
+
+        /*
+            batched flux, see `flux::batch`
+        */
+        static void flux_batch(const scalar_t *u_minus, const scalar_t *u_plus, scalar_t *f, const size_t n, const size_t ld, const size_t dim) {
+            batch<NE>(u_minus, u_plus, f, n, ld, [dim](const auto &um, const auto &up, auto &fb) { kernel(um, up, fb, dim); });
+        }
+
+        template<typename V>
+        static void kernel(const std::array<V, NE> &u_l, const std::array<V, NE> &u_r, std::array<V, NE> &f, const size_t dim) {
+            const size_t in = 1 + dim;
+            RoeState<Model, V> s(u_l, u_r);
+            const V un = s.v[dim];
+            const V c = s.c;
+
+            // wave strengths from the jumps of the primitive variables
+            V d_rho = s.rho_r - s.rho_l;
+            V d_p   = s.p_r - s.p_l;
+            V d_un  = s.v_r[dim] - s.v_l[dim];
+            V c2 = c * c;
+            V a_minus = (d_p - s.rho * c * d_un) / (2.0 * c2);
+            V a_plus  = (d_p + s.rho * c * d_un) / (2.0 * c2);
+            V a_0     = d_rho - d_p / c2;
+
+            // |lambda| alpha of the waves
+            V delta = entropy_fix * (simd::abs(un) + c);
+            V l_0 = simd::abs(un);
+            V w_minus = harten(un - c, delta) * a_minus;
+            V w_plus  = harten(un + c, delta) * a_plus;
+            V w_0 = l_0 * a_0;
+
+            std::array<V, NE> D;
+            D[0] = w_minus + w_0 + w_plus;
+            V shear = 0.0;      // sum over the shear waves of v_t |lambda| alpha_t
+            for (size_t i = 0; i < ND; ++i) {
+                if (i == dim) continue;
+                V w_t = l_0 * s.rho * (s.v_r[i] - s.v_l[i]);
+                D[1 + i] = (w_minus + w_0 + w_plus) * s.v[i] + w_t;
+                shear += s.v[i] * w_t;
+            }
+            D[in] = w_minus * (un - c) + w_0 * un + w_plus * (un + c);
+            D[ip] = w_minus * (s.H - un * c) + w_0 * (0.5 * s.q2) + w_plus * (s.H + un * c) + shear;
+
+            std::array<V, NE> F_l, F_r;
+            Model::flux_kernel(u_l, F_l, dim);
+            Model::flux_kernel(u_r, F_r, dim);
+            for (size_t k = 0; k < NE; k++) {
+                f[k] = (F_l[k] + F_r[k]) * 0.5 - D[k] * 0.5;
+            }
+        }
     };
 }
\ No newline at end of file
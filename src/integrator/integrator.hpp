@@ -1,28 +1,70 @@
 #pragma once
 
 #include <DG.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
 #include "core/basis.hpp"
+#include "core/blockTridiagonal.hpp"
+#include "core/comm.hpp"
+#include "core/kernels.hpp"
+#include "core/parallel.hpp"
 #include "cell.hpp"
+#include "field.hpp"
 #include "core/types.hpp"
 #include "mesh/mesh.hpp"
 #include "scene/scene.hpp"
 
 namespace DG::integrator {
 
-    template <typename Model, typename fSolver>
+    /* number of quadrature nodes per SoA packet in the volume flux evaluation */
+    inline constexpr size_t VolumePacket = 64;
+
+    /* face id of a cell side without a face */
+    inline constexpr size_t NoFace = std::numeric_limits<size_t>::max();
+
+    /* boundary face: the boundary condition it applies and the trace of its interior cell */
+    struct BoundaryFace {
+        size_t face;
+        size_t bc;      // index into Integrator::boundaries, i.e. into scene.boundary_conditions
+        size_t trace;   // offset of the interior trace in a state register
+    };
+
+    /**
+     * @brief the spatial discretization
+     *
+     * Policy = execution::parallel_policy splits the cell loops (fluxes, D, lifting, primitive
+     * recovery, the dt reduction and the time solver stages) over a thread pool. Every thread
+     * owns a static chunk of the cells and the dt minimum is combined in rank order, so the
+     * results are bit-identical to execution::sequenced_policy. With work stealing, the cell and
+     * face loops are split into tasks balanced by `cost_model`, which is updated from the
+     * measured run time of the right hand side.
+     */
+    template <typename Model, typename fSolver, const size_t NN = dynamic, typename Policy = execution::sequenced_policy>
     class Integrator {
     private:
         static constexpr size_t ND = Model::NumDims;
 
+        using var_t = typename Model::var_t;
+
     public:
+        using model_t = Model;
+        using flux_t = fSolver;
+        using cell_t = Cell<Model, NN>;
+        using state_t = typename cell_t::state_t;
+
         scene::Scene<Model> scene;
 
         RefCell ref_cell;
 
         std::vector<mesh::Face<ND>> faces;
-        std::vector<Cell<Model>> cells;
+        std::vector<std::array<size_t, 2>> cell_faces;  // [cell][L/R] face ids, TODO: higher dim
+        Field<Model, NN> field;
 
         const scalar_t Ncells;
         const scalar_t Nnodes;
@@ -30,99 +72,835 @@ namespace DG::integrator {
 
         scalar_t cfl;
 
+        mpi::Communicator comm;                         // ranks of a partitioned mesh, a single rank otherwise
+        std::vector<size_t> halo_faces;                 // partition faces, their remote cell lives on another rank
+        std::vector<size_t> halo_cells;                 // local cells of the partition faces, sorted
+        std::vector<unsigned char> on_halo;             // per cell, 1 for the halo cells
+        std::vector<size_t> interior_faces;             // faces with both cells on this rank
+        std::vector<std::array<size_t, 2>> interior_traces;     // offsets of their -/+ traces in a state register
+        std::vector<BoundaryFace> boundary_faces;       // grouped by boundary
+        std::vector<scene::Boundary<Model>> boundaries; // scene.boundary_conditions, resolved once
+        scalar_t time = 0.0;                            // time of the state in field.u, seen by the boundary conditions
+        std::vector<scalar_t> halo_send, halo_recv;     // local and remote traces, [halo face][eqn]
+
+        std::shared_ptr<execution::ThreadPool> pool;    // shared by copies, null for seq
+        bool work_stealing = false;                     // schedule the cell and face loops by stealing
+        execution::CostModel cost_model;                // per-cell cost of the right hand side
+
         /*
             Integrator constructor
         */
-        Integrator(mesh::Mesh<ND> &mesh, scene::Scene<Model> &scene, size_t porder, scalar_t cfl) 
-            : scene(scene), ref_cell(porder + 1), faces(mesh.faces), Ncells(mesh.Ncells), Nnodes(porder + 1), porder(porder), cfl(cfl)
+        Integrator(mesh::Mesh<ND> &mesh, scene::Scene<Model> &scene, size_t porder, scalar_t cfl, Policy policy = Policy{}) 
+            : scene(scene), ref_cell(porder + 1), faces(mesh.faces), cell_faces(mesh.Ncells, {NoFace, NoFace}),
+              field(mesh.Ncells, porder + 1, mesh.faces.size()), Ncells(mesh.Ncells), Nnodes(porder + 1), porder(porder), cfl(cfl)
         {   
-            std::cout << "Initializing the simulation ..." << std::endl;
+            comm = mpi::Communicator(mesh.Ncells < mesh.Ncells_global);
+
+            // ranks on the same node pin their threads to different cores
+            if constexpr (execution::is_parallel<Policy>) {
+                const size_t threads = policy.threads ? policy.threads : execution::default_threads();
+                pool = std::make_shared<execution::ThreadPool>(threads, policy.pin, comm.local_rank() * threads);
+                work_stealing = policy.work_stealing;
+                cost_model = execution::CostModel(field.Ncells);
+            }
+
+            // one packet of F and DF per thread for the fused stage kernel
+            const size_t packet = std::max<size_t>(1, VolumePacket / field.Nnodes) * field.stride();
+            field.resize_scratch(pool ? pool->size() : 1, 2 * packet);
+            if (comm.rank() == 0) std::cout << "Initializing the simulation ..." << std::endl;
 
             /*
                 Initialize integrator cells
             */
-            cells.reserve(Ncells);
             for (size_t i = 0; i < Ncells; i++) {
                 // get information from the mesh
-                cells.push_back(Cell<Model>(Nnodes));
-                cells[i].detJ = mesh.cells[i].detJ;
-                cells[i].size = mesh.cells[i].size;
+                field.detJ[i] = mesh.cells[i].detJ;
+                field.size[i] = mesh.cells[i].size;
 
                 // loop over each quadrature point and assign initial conditions
                 for (size_t j = 0; j < Nnodes; j++) {
-                    cells[i].x[j] = mesh.cells[i].map(ref_cell.x[j]);
-                    cells[i].p.fill_row(j, scene.initial_condition(cells[i].x[j]));
-                    cells[i].u.fill_row(j, Model::PtoU(cells[i].p[j]));
+                    field.x[i * Nnodes + j] = mesh.cells[i].map(ref_cell.x[j]);
+                }
+
+                auto c = cell(i);
+                for (size_t j = 0; j < Nnodes; j++) {
+                    c.p.fill_row(j, scene.initial_condition(c.x[j]));
+                    c.u.fill_row(j, Model::PtoU(c.p[j]));
                 }
-                cells[i].f_star[L] = 0.0;
-                cells[i].f_star[R] = 0.0;
             }
+
+            /*
+                the boundary conditions are evaluated here once instead of per face and stage; a
+                pair of periodic boundaries turns into the faces between the cells at both ends,
+                interior faces on a single rank and partition faces otherwise
+            */
+            boundaries.resize(scene.boundary_conditions.size());
+            for (size_t b = 0; b < boundaries.size(); b++) {
+                if (scene.boundary_conditions[b]) boundaries[b] = scene.boundary_conditions[b]();
+            }
+            auto periodic = [&](size_t b) {
+                return b < boundaries.size() && boundaries[b].template is<scene::bc::Periodic<Model>>();
+            };
+            if (periodic(LEFT) || periodic(RIGHT)) {
+                assert(periodic(LEFT) && periodic(RIGHT) && "Periodic boundaries come in pairs.");
+                size_t first = mesh::NoCell, last = mesh::NoCell;
+                for (const auto &face : faces) {
+                    if (face.loc == FaceLocation::LEFT)  first = face.ip;
+                    if (face.loc == FaceLocation::RIGHT) last  = face.im;
+                }
+                for (auto &face : faces) {
+                    if (face.loc == FaceLocation::LEFT) {
+                        face.im = (comm.size() > 1) ? mesh::NoCell : last;
+                        if (comm.size() > 1) face.rank = comm.size() - 1;
+                    } else if (face.loc == FaceLocation::RIGHT) {
+                        face.ip = (comm.size() > 1) ? mesh::NoCell : first;
+                        if (comm.size() > 1) face.rank = 0;
+                    } else {
+                        continue;
+                    }
+                    face.loc = FaceLocation::INTER;
+                }
+            }
+
+            /*
+                cell to face connectivity: the cell in the +normal dir sees the face on its left,
+                the cell in the -normal dir on its right. Boundary faces only feed the interior cell.
+
+                The faces are sorted into halo, interior and boundary lists, with the offsets of
+                their traces in the state registers.
+            */
+            const size_t stride = field.stride();
+            const size_t last = (field.Nnodes - 1) * Model::NumEqns;   // offset of the last node of a cell
+            for (size_t f = 0; f < faces.size(); f++) {
+                const auto &face = faces[f];
+                if (face.loc != FaceLocation::RIGHT && face.ip != mesh::NoCell) cell_faces[face.ip][L] = f;
+                if (face.loc != FaceLocation::LEFT  && face.im != mesh::NoCell) cell_faces[face.im][R] = f;
+
+                if (face.rank >= 0) {
+                    halo_faces.push_back(f);
+                } else if (face.loc == FaceLocation::INTER) {
+                    interior_faces.push_back(f);
+                    interior_traces.push_back({face.im * stride + last, face.ip * stride});
+                } else {
+                    // the interior cell is in the +normal dir of a LEFT face
+                    assert(face.loc < boundaries.size() && scene.boundary_conditions[face.loc] && "Missing boundary condition.");
+                    const size_t trace = (face.loc == FaceLocation::LEFT) ? face.ip * stride : face.im * stride + last;
+                    boundary_faces.push_back({f, face.loc, trace});
+                }
+            }
+            std::stable_sort(boundary_faces.begin(), boundary_faces.end(), [](const auto &a, const auto &b) { return a.bc < b.bc; });
+
+            on_halo.assign(field.Ncells, 0);
+            for (size_t f : halo_faces) {
+                on_halo[(faces[f].ip != mesh::NoCell) ? faces[f].ip : faces[f].im] = 1;
+            }
+            for (size_t c = 0; c < field.Ncells; c++) {
+                if (on_halo[c]) halo_cells.push_back(c);
+            }
+            field.resize_traces(interior_faces.size());
+            assert((halo_faces.empty() || comm.size() > 1) && "Partitioned mesh without MPI.");
+            halo_send.resize(halo_faces.size() * Model::NumEqns);
+            halo_recv.resize(halo_faces.size() * Model::NumEqns);
+        }
+
+        // view of the i-th cell
+        cell_t cell(const size_t i) {
+            return field.cell(i);
+        }
+
+        /*
+            allocate the field registers of the mask (`Registers`) on first use. All threads
+            check them before the first barrier and only the first thread allocates after it,
+            so once they exist this costs no barrier.
+        */
+        void reserve(const execution::Team &team, unsigned registers) {
+            if (field.reserved(registers)) return;
+            team.sync();
+            if (team.rank == 0) field.reserve(registers);
+            team.sync();
+        }
+
+        // CFL time step of the i-th cell
+        scalar_t compute_dt(const size_t i) {
+            const scalar_t scale = std::pow(std::max<scalar_t>(porder - 1, 1.0), 2);    // p = 1 scales as p = 2
+            return cfl * Model::compute_dt(cell(i)) / scale;
         }
 
-        scalar_t compute_dt_global(){
+        /*
+            f(team) on every thread of the policy, i.e. once on the calling thread for seq
+        */
+        template<typename F>
+        void run_team(F &&f) {
+            if constexpr (execution::is_parallel<Policy>) {
+                pool->run([&](size_t t) { f(pool->team(t, work_stealing)); });
+            } else {
+                f(execution::Team{});
+            }
+        }
+
+        /*
+            The methods below come in two forms: with a team, every thread works on its static
+            chunk of cells or faces and synchronizes where it reads data of other threads; without,
+            they open a parallel region of their own.
+        */
+        scalar_t compute_dt_global(const execution::Team &team) {
+            auto [begin, end] = team.chunk(field.Ncells);
             scalar_t dt_global = std::numeric_limits<scalar_t>::max();
-            for (auto &cell : cells) {
-                scalar_t dt = cfl * Model::compute_dt(cell) / std::pow(porder - 1, 2);
-                dt_global = std::min(dt_global, dt);
+            for (size_t i = begin; i < end; i++) {
+                dt_global = std::min(dt_global, compute_dt(i));
+            }
+            dt_global = team.reduce(dt_global, [](scalar_t a, scalar_t b) { return std::min(a, b); });
+
+            // minimum over the ranks, by the first thread of the team
+            if (comm.size() > 1) {
+                if (team.rank == 0) dt_global = comm.allreduce_min(dt_global);
+                dt_global = team.broadcast(dt_global);
             }
             return dt_global;
         }
 
+        scalar_t compute_dt_global() {
+            scalar_t dt = 0.0;
+            run_team([&](const execution::Team &team) {
+                scalar_t dt_team = compute_dt_global(team);
+                if (team.rank == 0) dt = dt_team;
+            });
+            return dt;
+        }
+
+        /*
+            numerical fluxes, owner computes
+
+            Every face writes its flux only to its own slot of field.f_face, then every cell
+            gathers the fluxes of its faces into its own f_star. Neither pass writes memory
+            owned by another face or cell, so both are race-free for any ip/im layout.
+
+            On a partitioned mesh the traces at the partition faces are exchanged with the
+            neighbouring ranks by nonblocking messages, started before and completed after the
+            local face work. MPI is only called by the first thread of the team. The fluxes are
+            all this computes, so only the local faces hide the exchange here. `compute_rhs`
+            (BDF2, the steady solver) also hides it behind the volume terms of all cells, and
+            `compute_stage` (the explicit solvers) behind the complete stage of the cells off
+            the partition faces. LTS does not support partitioned meshes.
+        */
+        void compute_flux(const execution::Team &team) {
+            if (team.rank == 0) start_halo();
+            compute_face_fluxes(team);
+            finish_halo(team);
+            gather_fluxes(team);
+        }
+
         void compute_flux() {
-            for (auto &face : faces) {
-                if (face.loc == FaceLocation::LEFT) {
+            run_team([&](const execution::Team &team) { compute_flux(team); });
+        }
 
-                    auto &c = cells[face.ip];   // ip, im points to the same cell for boundary faces
-                    vec_t ub = scene.boundary_conditions[LEFT]().boundary_value(c.u[0]);
-                    c.f_star[L] = Model::Fu(ub, 0);
+        /*
+            right hand side of all cells, written to field.dudt
 
-                } else if (face.loc == FaceLocation::RIGHT) {
+            dudt = (MinvB * (F - F_star) - D * F) / detJ
+        */
+        void compute_dudt(const execution::Team &team) {
+            reserve(team, Registers::RHS);
+            compute_volume(team);
+            compute_lift(team);
+        }
 
-                    auto &c = cells[face.im];   // ip, im points to the same cell for boundary faces
-                    vec_t ub = scene.boundary_conditions[RIGHT]().boundary_value(c.u[Nnodes-1]);
-                    c.f_star[R] = Model::Fu(ub, 0);
+        void compute_dudt() {
+            run_team([&](const execution::Team &team) { compute_dudt(team); });
+        }
 
-                } else {
-                    auto &cp = cells[face.ip];  // cell in the +normal dir
-                    auto &cm = cells[face.im];  // cell in the -normal dir
+        /*
+            numerical fluxes and right hand side in one pass; the halo exchange overlaps with
+            the volume terms and the local faces
+        */
+        void compute_rhs(const execution::Team &team) {
+            reserve(team, Registers::RHS);
+            if (team.rank == 0) start_halo();
+            compute_volume(team);
+            compute_face_fluxes(team);
+            finish_halo(team);
+            gather_fluxes(team);
+            compute_lift(team);
+        }
+
+        void compute_rhs() {
+            run_team([&](const execution::Team &team) { compute_rhs(team); });
+        }
+
+        /*
+            send the local traces at the partition faces, receive the remote ones
+        */
+        void start_halo() {
+            constexpr size_t NE = Model::NumEqns;
+
+            for (size_t h = 0; h < halo_faces.size(); h++) {
+                const auto &face = faces[halo_faces[h]];
+                const bool left = (face.ip != mesh::NoCell);    // local cell in the +normal dir
+
+                // tag: 0 for the left trace of a partition, 1 for the right one
+                auto c = left ? cell(face.ip) : cell(face.im);
+                var_t u = left ? var_t(c.u[0]) : var_t(c.u[Nnodes - 1]);
+                for (size_t k = 0; k < NE; k++) {
+                    halo_send[h * NE + k] = u[k];
+                }
+                comm.irecv(halo_recv.data() + h * NE, NE, face.rank, left ? 1 : 0);
+                comm.isend(halo_send.data() + h * NE, NE, face.rank, left ? 0 : 1);
+            }
+        }
+
+        /*
+            wait for the remote traces and compute the partition face fluxes
+        */
+        void finish_halo(const execution::Team &team) {
+            constexpr size_t NE = Model::NumEqns;
 
-                    // TODO: should use quadrature in multi D for higher order
-                    vec_t u_minus = cm.u[Nnodes - 1];
-                    vec_t u_plus  = cp.u[0];
+            if (team.rank == 0 && !halo_faces.empty()) {
+                comm.wait_all();
+                for (size_t h = 0; h < halo_faces.size(); h++) {
+                    const auto &face = faces[halo_faces[h]];
+                    var_t remote;
+                    for (size_t k = 0; k < NE; k++) {
+                        remote[k] = halo_recv[h * NE + k];
+                    }
 
                     // TODO: higher dim
-                    cm.f_star[R] = fSolver::flux(u_minus, u_plus, 0.0);
-                    cp.f_star[L] = cm.f_star[R];
+                    var_t f = (face.ip != mesh::NoCell)
+                        ? fSolver::flux(remote, cell(face.ip).u[0], 0.0)
+                        : fSolver::flux(cell(face.im).u[Nnodes - 1], remote, 0.0);
+
+                    for (size_t k = 0; k < NE; k++) {
+                        field.f_face[halo_faces[h] * NE + k] = f[k];
+                    }
                 }
             }
+
+            // the face fluxes of a cell may come from other threads
+            if (!team.stealing() || !halo_faces.empty()) team.sync();
+        }
+
+        /*
+            fluxes of the faces with both cells on this rank
+
+            The boundary faces apply their resolved condition. The traces of the interior faces
+            are gathered into the SoA buffers field.trace_minus / trace_plus and evaluated by the
+            batched numerical flux (fSolver::flux_batch) without any branch on the face type.
+        */
+        void compute_face_fluxes(const execution::Team &team) {
+            constexpr size_t NE = Model::NumEqns;
+            const scalar_t *u = field.u.data();
+
+            // only a few boundary faces, static chunks
+            auto [bb, be] = team.chunk(boundary_faces.size());
+            compute_boundary_fluxes(be - bb, [&](size_t j) { return bb + j; }, time);
+
+            const size_t n = interior_faces.size();
+            team.for_each(n, [&](size_t begin, size_t end) {
+                scalar_t *u_minus = field.trace_minus.data();
+                scalar_t *u_plus  = field.trace_plus.data();
+                scalar_t *f       = field.f_trace.data();
+
+                for (size_t j = begin; j < end; j++) {
+                    const scalar_t *um = u + interior_traces[j][0];
+                    const scalar_t *up = u + interior_traces[j][1];
+                    for (size_t k = 0; k < NE; k++) {
+                        u_minus[k * n + j] = um[k];
+                        u_plus[k * n + j]  = up[k];
+                    }
+                }
+
+                // TODO: higher dim
+                fSolver::flux_batch(u_minus + begin, u_plus + begin, f + begin, end - begin, n, 0);
+
+                for (size_t j = begin; j < end; j++) {
+                    scalar_t *f_face = field.f_face.data() + interior_faces[j] * NE;
+                    for (size_t k = 0; k < NE; k++) {
+                        f_face[k] = f[k * n + j];
+                    }
+                }
+            });
         }
 
-        mat_t dudt(auto &cell) {
-            mat_t F_star(Nnodes, Model::NumEqns); 
-            mat_t F(Nnodes, Model::NumEqns); 
-            mat_t dudt(Nnodes, Model::NumEqns);
+        /*
+            fluxes of the boundary faces boundary_faces[index(j)], j < n, at time t from the
+            current traces of their cells, written to field.f_face. The faces of a boundary are
+            consecutive in boundary_faces, so for increasing indices the policy of a boundary is
+            dispatched once for the run of its faces.
+        */
+        template<typename Index>
+        void compute_boundary_fluxes(size_t n, Index &&index, scalar_t t) {
+            constexpr size_t NE = Model::NumEqns;
+            const scalar_t *u = field.u.data();
 
-            F_star = 0.0;
-            F_star.fill_row(0, cell.f_star[L]);
-            F_star.fill_row(Nnodes - 1, cell.f_star[R]);
+            for (size_t b = 0; b < n;) {
+                const size_t id = boundary_faces[index(b)].bc;
+                size_t e = b;
+                while (e < n && boundary_faces[index(e)].bc == id) e++;
 
+                boundaries[id].visit([&](const auto &policy) {
+                    for (size_t j = b; j < e; j++) {
+                        const auto &bf = boundary_faces[index(j)];
+                        const auto &face = faces[bf.face];
+                        var_t u_cell;
+                        for (size_t k = 0; k < NE; k++) {
+                            u_cell[k] = u[bf.trace + k];
+                        }
+                        // TODO: higher dim
+                        var_t ub = policy(u_cell, face.center, face.n, t);
+                        var_t f = (face.loc == FaceLocation::LEFT) ? fSolver::flux(ub, u_cell, 0) : fSolver::flux(u_cell, ub, 0);
+                        for (size_t k = 0; k < NE; k++) {
+                            field.f_face[bf.face * NE + k] = f[k];
+                        }
+                    }
+                });
+                b = e;
+            }
+        }
+
+        /*
+            numerical flux of the interior face f for the traces of its two sides; the boundary
+            faces are computed by compute_boundary_fluxes
+        */
+        var_t face_flux(const size_t f, const var_t &u_minus, const var_t &u_plus) {
+            assert(faces[f].loc == FaceLocation::INTER && "Boundary face without its condition.");
             // TODO: higher dim
-            for (size_t i = 0; i < Nnodes; i++) {
-                F.fill_row(i, Model::Fu(cell.u[i], 0.0));
+            return fSolver::flux(u_minus, u_plus, 0.0);
+        }
+
+        // f_star of every cell from the fluxes of its faces
+        void gather_fluxes(const execution::Team &team) {
+            constexpr size_t NE = Model::NumEqns;
+
+            team.for_each(field.Ncells, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; c++) {
+                    for (size_t side : {L, R}) {
+                        const scalar_t *f = field.f_face.data() + cell_faces[c][side] * NE;
+                        scalar_t *fs = field.f_star.data() + (2 * c + side) * NE;
+                        for (size_t k = 0; k < NE; k++) {
+                            fs[k] = f[k];
+                        }
+                    }
+                }
+            });
+        }
+
+        /*
+            physical flux at the quadrature points of cells [begin, end)
+
+            The nodes of all cells are contiguous in the field, they are transposed to SoA
+            packets and evaluated with the batched (SIMD) model flux. The result is stored
+            node-major, [node][cell][eqn], i.e. as one tall (Nnodes x ncells*NumEqns) block: F
+            points to the first cell of the range and ldc is the number of cells per node row,
+            field.F with Ncells by default.
+        */
+        void compute_volume_flux(size_t begin, size_t end) {
+            compute_volume_flux(begin, end, field.F.data() + begin * Model::NumEqns, field.Ncells);
+        }
+
+        void compute_volume_flux(size_t begin, size_t end, scalar_t *F_begin, size_t ldc) {
+            constexpr size_t NE = Model::NumEqns;
+            constexpr size_t P  = VolumePacket;
+
+            std::array<scalar_t, NE * P> u_soa, F_soa;
+            const size_t NP = field.Nnodes;
+            const size_t node_end = end * NP;
+
+            for (size_t start = begin * NP; start < node_end; start += P) {
+                const size_t n = std::min(P, node_end - start);
+
+                const scalar_t *u = field.u.data() + start * NE;
+                for (size_t i = 0; i < n; i++) {
+                    for (size_t k = 0; k < NE; k++) {
+                        u_soa[k * P + i] = u[i * NE + k];
+                    }
+                }
+
+                // TODO: higher dim
+                Model::Fu_batch(u_soa.data(), F_soa.data(), n, P, 0);
+
+                for (size_t i = 0; i < n; i++) {
+                    const size_t c = (start + i) / NP;  // cell
+                    const size_t j = (start + i) % NP;  // node
+                    scalar_t *F = F_begin + (j * ldc + c - begin) * NE;
+                    for (size_t k = 0; k < NE; k++) {
+                        F[k] = F_soa[k * P + i];
+                    }
+                }
             }
+        }
 
-            dudt  = ref_cell.MinvB * (F - F_star) - ref_cell.D * F;
-            dudt /= cell.detJ;
+        /*
+            volume terms: field.F and field.DF = D * F
+
+            D is applied to all cells of a range at once by the batched kernel on the node-major
+            volume flux, the columns of a range are the columns of its cells.
+        */
+        void compute_volume(const execution::Team &team) {
+            constexpr size_t NE = Model::NumEqns;
+            const size_t NC = field.Ncells;
+            const size_t NP = field.Nnodes;
+            const size_t ld = NC * NE;
+
+            // reference operator, compile-time table for supported node counts
+            const scalar_t *D = ref_cell.D.data();
+            if constexpr (NN != dynamic && NN <= MaxTableNodes) {
+                D = ref_table<NN>.D.data();
+            }
+
+            auto kernel = [&](size_t begin, size_t end) {
+                auto start = std::chrono::steady_clock::now();
+
+                compute_volume_flux(begin, end);
+                kernels::gemm<NN>(D, NP, field.F.data() + begin * NE, ld, field.DF.data() + begin * NE, ld, (end - begin) * NE);
 
-            return dudt;
+                if (team.stealing()) {
+                    std::chrono::duration<scalar_t> elapsed = std::chrono::steady_clock::now() - start;
+                    cost_model.record(begin, end, elapsed.count());
+                }
+            };
+
+            if (!team.stealing()) {
+                team.for_each(NC, kernel);
+                return;
+            }
+
+            // balance the tasks with the measured costs, then fold in the new timings
+            team.for_each(NC, kernel, cost_model.data());
+            auto [begin, end] = team.chunk(NC);
+            cost_model.commit(begin, end);
+            team.sync();
         }
 
-        void update_primitive() {
-            for (auto &cell : cells) {
-                for (size_t i = 0; i < Nnodes; i++) {
-                    cell.p.fill_row(i, Model::UtoP(cell.u[i]));
+        /*
+            dudt = (MinvB * (F - F_star) - DF) / detJ
+
+            B only touches the first and last node, so MinvB * (F - F_star) reduces to the two
+            lift vectors scaled by the flux jumps at the cell boundaries.
+        */
+        void compute_lift(const execution::Team &team) {
+            constexpr size_t NE = Model::NumEqns;
+            const size_t NC = field.Ncells;
+            const size_t NP = field.Nnodes;
+
+            // reference operators, compile-time tables for supported node counts
+            const scalar_t *lift_L = ref_cell.lift_L.data();
+            const scalar_t *lift_R = ref_cell.lift_R.data();
+            if constexpr (NN != dynamic && NN <= MaxTableNodes) {
+                lift_L = ref_table<NN>.lift_L.data();
+                lift_R = ref_table<NN>.lift_R.data();
+            }
+
+            team.for_each(NC, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; c++) {
+                    const scalar_t *F_L  = field.F.data()  + c * NE;                    // first node
+                    const scalar_t *F_R  = field.F.data()  + ((NP - 1) * NC + c) * NE;  // last node
+                    const scalar_t *fs_L = field.f_star.data() + (2 * c + L) * NE;
+                    const scalar_t *fs_R = field.f_star.data() + (2 * c + R) * NE;
+
+                    std::array<scalar_t, NE> jump_L, jump_R;
+                    for (size_t k = 0; k < NE; k++) {
+                        jump_L[k] = F_L[k] - fs_L[k];
+                        jump_R[k] = F_R[k] - fs_R[k];
+                    }
+
+                    scalar_t *du = field.dudt.data() + c * field.stride();
+                    for (size_t i = 0; i < NP; i++) {
+                        const scalar_t *DF = field.DF.data() + (i * NC + c) * NE;
+                        for (size_t k = 0; k < NE; k++) {
+                            scalar_t lift = lift_L[i] * jump_L[k] + lift_R[i] * jump_R[k];
+                            du[i * NE + k] = (lift - DF[k]) / field.detJ[c];
+                        }
+                    }
                 }
+            });
+        }
+
+        /*
+            one explicit stage in a single sweep over the cells: update(i, dudt_i) for every
+            value i of the state registers, with the right hand side of the current u
+
+            The local face fluxes are computed first from the cell traces, so the cells only read
+            their own u afterwards and can overwrite it in place. The cells are then processed in
+            packets of about VolumePacket nodes: volume flux, D, lifting and the stage combination
+            all work on the packet while it is in cache, in the scratch of the thread; F, DF and
+            dudt of the field are neither written nor allocated. On a partitioned mesh the cells
+            off the partition faces are advanced while the halo messages are in flight, the halo
+            cells once the partition fluxes are complete. The results are bit-identical to
+            compute_rhs followed by a loop over dudt. The caller synchronizes before the next
+            stage.
+        */
+        template<typename Update>
+        void compute_stage(const execution::Team &team, Update &&update) {
+            constexpr size_t NE = Model::NumEqns;
+            const size_t NC = field.Ncells;
+            const size_t NP = field.Nnodes;
+            const size_t PC = std::max<size_t>(1, VolumePacket / NP);  // cells per packet
+
+            // reference operators, compile-time tables for supported node counts
+            const scalar_t *D = ref_cell.D.data();
+            const scalar_t *lift_L = ref_cell.lift_L.data();
+            const scalar_t *lift_R = ref_cell.lift_R.data();
+            if constexpr (NN != dynamic && NN <= MaxTableNodes) {
+                D = ref_table<NN>.D.data();
+                lift_L = ref_table<NN>.lift_L.data();
+                lift_R = ref_table<NN>.lift_R.data();
             }
+
+            // every face flux reads its traces before a cell is overwritten
+            const bool overlap = !halo_faces.empty();
+            if (team.rank == 0) start_halo();
+            compute_face_fluxes(team);
+            if (overlap) {
+                team.sync();
+            } else {
+                finish_halo(team);
+            }
+
+            assert(team.rank < field.scratch.size() && "Team larger than the pool of the integrator.");
+            scalar_t *F  = field.scratch[team.rank].data();
+            scalar_t *DF = F + PC * NP * NE;
+
+            // cells [begin, end) in packets
+            auto stage = [&](size_t begin, size_t end) {
+                for (size_t p0 = begin; p0 < end; p0 += PC) {
+                    const size_t p1 = std::min(end, p0 + PC);
+                    const size_t nc = p1 - p0;
+                    const size_t ld = nc * NE;
+
+                    compute_volume_flux(p0, p1, F, nc);
+                    kernels::gemm<NN>(D, NP, F, ld, DF, ld, ld);
+
+                    for (size_t c = p0; c < p1; c++) {
+                        const size_t q = c - p0;    // column of the cell in the packet
+                        const scalar_t *F_L  = F + q * NE;
+                        const scalar_t *F_R  = F + ((NP - 1) * nc + q) * NE;
+                        const scalar_t *fs_L = field.f_face.data() + cell_faces[c][L] * NE;
+                        const scalar_t *fs_R = field.f_face.data() + cell_faces[c][R] * NE;
+
+                        std::array<scalar_t, NE> jump_L, jump_R;
+                        for (size_t k = 0; k < NE; k++) {
+                            jump_L[k] = F_L[k] - fs_L[k];
+                            jump_R[k] = F_R[k] - fs_R[k];
+                        }
+
+                        const size_t offset = c * field.stride();
+                        for (size_t i = 0; i < NP; i++) {
+                            const scalar_t *DFi = DF + (i * nc + q) * NE;
+                            for (size_t k = 0; k < NE; k++) {
+                                scalar_t lift = lift_L[i] * jump_L[k] + lift_R[i] * jump_R[k];
+                                update(offset + i * NE + k, (lift - DFi[k]) / field.detJ[c]);
+                            }
+                        }
+                    }
+                }
+            };
+
+            // the runs of cells between the halo cells
+            auto kernel = [&](size_t begin, size_t end) {
+                auto start = std::chrono::steady_clock::now();
+
+                for (size_t b = begin; b < end;) {
+                    if (on_halo[b]) {
+                        b++;
+                        continue;
+                    }
+                    size_t e = b;
+                    while (e < end && !on_halo[e]) e++;
+                    stage(b, e);
+                    b = e;
+                }
+
+                if (team.stealing()) {
+                    std::chrono::duration<scalar_t> elapsed = std::chrono::steady_clock::now() - start;
+                    cost_model.record(begin, end, elapsed.count());
+                }
+            };
+
+            if (!team.stealing()) {
+                team.for_each(NC, kernel);
+            } else {
+                team.for_each(NC, kernel, cost_model.data());
+                auto [begin, end] = team.chunk(NC);
+                cost_model.commit(begin, end);
+            }
+            if (!overlap) return;
+
+            finish_halo(team);
+            auto [hb, he] = team.chunk(halo_cells.size());
+            for (size_t h = hb; h < he; h++) {
+                stage(halo_cells[h], halo_cells[h] + 1);
+            }
+        }
+
+        // lift vector of side L/R, compile-time table for supported node counts
+        const scalar_t* lift(const size_t side) const {
+            if constexpr (NN != dynamic && NN <= MaxTableNodes) {
+                return (side == L) ? ref_table<NN>.lift_L.data() : ref_table<NN>.lift_R.data();
+            }
+            return (side == L) ? ref_cell.lift_L.data() : ref_cell.lift_R.data();
+        }
+
+        /*
+            right hand side of cell c for the face fluxes f_L, f_R at its left and right side,
+            written to du; scratch holds 2 * Nnodes * NumEqns values, e.g. field.scratch of the
+            thread
+        */
+        void compute_cell_rhs(const size_t c, const scalar_t *f_L, const scalar_t *f_R, scalar_t *scratch, scalar_t *du) {
+            constexpr size_t NE = Model::NumEqns;
+            const size_t NP = field.Nnodes;
+
+            const scalar_t *D = ref_cell.D.data();
+            if constexpr (NN != dynamic && NN <= MaxTableNodes) {
+                D = ref_table<NN>.D.data();
+            }
+            const scalar_t *lift_L = lift(L);
+            const scalar_t *lift_R = lift(R);
+
+            scalar_t *F = scratch;
+            scalar_t *DF = scratch + NP * NE;
+            compute_volume_flux(c, c + 1, F, 1);
+            kernels::gemm<NN>(D, NP, F, NE, DF, NE, NE);
+
+            std::array<scalar_t, NE> jump_L, jump_R;
+            for (size_t k = 0; k < NE; k++) {
+                jump_L[k] = F[k] - f_L[k];
+                jump_R[k] = F[(NP - 1) * NE + k] - f_R[k];
+            }
+            for (size_t i = 0; i < NP; i++) {
+                for (size_t k = 0; k < NE; k++) {
+                    scalar_t lift = lift_L[i] * jump_L[k] + lift_R[i] * jump_R[k];
+                    du[i * NE + k] = (lift - DF[i * NE + k]) / field.detJ[c];
+                }
+            }
+        }
+
+        /*
+            J = shift * I + scale * dL/du for the right hand side L(u) = dudt, in 1D
+
+            Every cell only couples to the cells across its two faces, so J is block
+            tridiagonal with (Nnodes * NumEqns)^2 blocks in the order of the cell values, with
+            corner blocks on a periodic mesh. The fluxes are differentiated analytically
+            (Model::dFdu, fSolver::flux_jacobian, Boundary::boundary_jacobian). Block row c is
+            written by the thread that owns cell c.
+        */
+        void assemble_jacobian(const execution::Team &team, BlockTridiagonal<scalar_t> &J, scalar_t shift, scalar_t scale) {
+            constexpr size_t NE = Model::NumEqns;
+            using jac_t = typename Model::jac_t;
+            const size_t NC = field.Ncells;
+            const size_t NP = field.Nnodes;
+            const size_t NB = NP * NE;
+
+            assert(comm.size() == 1 && "Jacobian assembly on a partitioned mesh.");
+            const bool periodic = faces[cell_faces[0][L]].loc == FaceLocation::INTER;
+            if (team.rank == 0 && (J.blocks() != NC || J.block_size() != NB || J.periodic() != periodic)) {
+                J.resize(NC, NB, periodic);
+            }
+            team.sync();
+
+            const scalar_t *lift_L = lift(L);
+            const scalar_t *lift_R = lift(R);
+
+            // block(i, j) += s * A for the equations of nodes i and j
+            auto add = [](mat_t &block, size_t i, size_t j, scalar_t s, const jac_t &A) {
+                for (size_t k = 0; k < NE; k++) {
+                    for (size_t l = 0; l < NE; l++) {
+                        block(i * NE + k, j * NE + l) += s * A(k, l);
+                    }
+                }
+            };
+            // A B for the outside states of the boundaries
+            auto product = [](const jac_t &A, const jac_t &B) {
+                jac_t C;
+                C = 0.0;
+                for (size_t k = 0; k < NE; k++) {
+                    for (size_t m = 0; m < NE; m++) {
+                        for (size_t l = 0; l < NE; l++) {
+                            C(k, l) += A(k, m) * B(m, l);
+                        }
+                    }
+                }
+                return C;
+            };
+
+            auto [begin, end] = team.chunk(NC);
+            for (size_t c = begin; c < end; c++) {
+                mat_t &lower = J.lower[c];
+                mat_t &diag  = J.diag[c];
+                mat_t &upper = J.upper[c];
+                lower = 0.0;
+                diag  = 0.0;
+                upper = 0.0;
+
+                auto cc = cell(c);
+                const scalar_t s = scale / field.detJ[c];
+
+                // volume: -D F
+                for (size_t j = 0; j < NP; j++) {
+                    jac_t A = Model::dFdu(var_t(cc.u[j]), 0);
+                    for (size_t i = 0; i < NP; i++) {
+                        add(diag, i, j, -s * ref_cell.D(i, j), A);
+                    }
+                }
+
+                // lifting of F - f_star at the first node
+                const var_t u_first = cc.u[0];
+                jac_t A_first = Model::dFdu(u_first, 0);
+                jac_t J_self, J_other;
+                const auto &face_L = faces[cell_faces[c][L]];
+                if (face_L.loc == FaceLocation::LEFT) {
+                    // the outside state depends on the trace
+                    const auto &bc = boundaries[LEFT];
+                    fSolver::flux_jacobian(bc.boundary_value(u_first, face_L.center, face_L.n, time), u_first, 0, J_other, J_self);
+                    J_self += product(J_other, bc.boundary_jacobian(u_first, face_L.n));
+                } else {
+                    var_t u_minus = cell(face_L.im).u[Nnodes - 1];
+                    fSolver::flux_jacobian(u_minus, u_first, 0, J_other, J_self);
+                    for (size_t i = 0; i < NP; i++) add(lower, i, NP - 1, -s * lift_L[i], J_other);
+                }
+                for (size_t i = 0; i < NP; i++) {
+                    add(diag, i, 0, s * lift_L[i], A_first);
+                    add(diag, i, 0, -s * lift_L[i], J_self);
+                }
+
+                // and at the last node
+                const var_t u_last = cc.u[NP - 1];
+                jac_t A_last = Model::dFdu(u_last, 0);
+                const auto &face_R = faces[cell_faces[c][R]];
+                if (face_R.loc == FaceLocation::RIGHT) {
+                    const auto &bc = boundaries[RIGHT];
+                    fSolver::flux_jacobian(u_last, bc.boundary_value(u_last, face_R.center, face_R.n, time), 0, J_self, J_other);
+                    J_self += product(J_other, bc.boundary_jacobian(u_last, face_R.n));
+                } else {
+                    var_t u_plus = cell(face_R.ip).u[0];
+                    fSolver::flux_jacobian(u_last, u_plus, 0, J_self, J_other);
+                    for (size_t i = 0; i < NP; i++) add(upper, i, 0, -s * lift_R[i], J_other);
+                }
+                for (size_t i = 0; i < NP; i++) {
+                    add(diag, i, NP - 1, s * lift_R[i], A_last);
+                    add(diag, i, NP - 1, -s * lift_R[i], J_self);
+                }
+
+                for (size_t i = 0; i < NB; i++) diag(i, i) += shift;
+            }
+            team.sync();
+        }
+
+        void assemble_jacobian(BlockTridiagonal<scalar_t> &J, scalar_t shift, scalar_t scale) {
+            run_team([&](const execution::Team &team) { assemble_jacobian(team, J, shift, scale); });
+        }
+
+        void update_primitive(const execution::Team &team) {
+            team.for_each(field.Ncells, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    auto c = cell(i);
+                    for (size_t j = 0; j < Nnodes; j++) {
+                        c.p.fill_row(j, Model::UtoP(c.u[j]));
+                    }
+                }
+            });
+        }
+
+        void update_primitive() {
+            run_team([&](const execution::Team &team) { update_primitive(team); });
         }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <DG.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "core/comm.hpp"
+#include "core/parallel.hpp"
+
+namespace DG::integrator::implicit {
+
+    /**
+     * @brief preconditioner of the Newton-Krylov solver
+     *
+     * setup(team, x) is called at every Newton iterate x, after the residual of x; apply(team,
+     * v) replaces v by M^-1 v. Both are called by all threads of the team, apply may read all
+     * of v and finishes with a barrier.
+     */
+    template<typename Setup, typename Apply>
+    struct Preconditioner {
+        Setup setup;
+        Apply apply;
+    };
+
+    /* M = I */
+    struct Identity {
+        void setup(const execution::Team&, const scalar_t*) {}
+        void apply(const execution::Team&, scalar_t*) {}
+    };
+
+    /**
+     * @brief Jacobian-free Newton-Krylov solver for G(x) = 0
+     *
+     * Every Newton iteration solves J dx = -G(x) with restarted GMRES, where the Jacobian is
+     * never formed: J v = (G(x + eps v) - G(x)) / eps costs one residual evaluation. The
+     * linear solves are inexact, GMRES stops at `krylov_rtol` times the Newton residual.
+     *
+     * With a preconditioner M, GMRES solves the right-preconditioned system J M^-1 z = -G and
+     * dx = M^-1 z; with `krylov = false` Newton takes dx = -M^-1 G directly, i.e. M is used as
+     * the (approximate) Jacobian of a direct solve.
+     *
+     * All vectors have n values and are split into the static chunks of the team; the inner
+     * products are reduced over the team in rank order and over the ranks of `comm`. The
+     * small GMRES problem (Hessenberg matrix, Givens rotations) is solved redundantly on every
+     * thread, so only the long vectors are shared.
+     */
+    class NewtonKrylov {
+    private:
+
+        size_t n = 0;
+        std::vector<aligned_vec<scalar_t>> V;   // Krylov basis
+        aligned_vec<scalar_t> G, Gp, dx, xp, Mv;
+
+        const mpi::Communicator *comm = nullptr;
+
+        scalar_t dot(const execution::Team &team, const scalar_t *a, const scalar_t *b) const {
+            auto [begin, end] = team.chunk(n);
+            scalar_t sum = 0.0;
+            for (size_t i = begin; i < end; i++) {
+                sum += a[i] * b[i];
+            }
+            sum = team.reduce(sum, [](scalar_t x, scalar_t y) { return x + y; });
+            if (comm && comm->size() > 1) {
+                if (team.rank == 0) sum = comm->allreduce_sum(sum);
+                sum = team.broadcast(sum);
+            }
+            return sum;
+        }
+
+        scalar_t norm(const execution::Team &team, const scalar_t *a) const {
+            return std::sqrt(dot(team, a, a));
+        }
+
+        // f(i) on the values of the team thread
+        template<typename F>
+        void for_each(const execution::Team &team, F &&f) const {
+            auto [begin, end] = team.chunk(n);
+            for (size_t i = begin; i < end; i++) f(i);
+        }
+
+        /*
+            J v by a forward difference around x, where G holds G(x); the step is scaled by |v|,
+            so that |eps v| = sqrt(eps_mach) (1 + |x|) for any length of v
+        */
+        template<typename Residual>
+        void jacobian_vector(const execution::Team &team, Residual &residual, const scalar_t *x, scalar_t x_norm,
+                             const scalar_t *v, scalar_t *Jv)
+        {
+            const scalar_t v_norm = norm(team, v);
+            if (v_norm == 0.0) {
+                for_each(team, [&](size_t i) { Jv[i] = 0.0; });
+                return;
+            }
+            const scalar_t eps = std::sqrt(std::numeric_limits<scalar_t>::epsilon()) * (1.0 + x_norm) / v_norm;
+            for_each(team, [&](size_t i) { xp[i] = x[i] + eps * v[i]; });
+            residual(team, xp.data(), Gp.data());
+            for_each(team, [&](size_t i) { Jv[i] = (Gp[i] - G[i]) / eps; });
+        }
+
+        // J M^-1 v
+        template<typename Residual, typename Precond>
+        void operator_vector(const execution::Team &team, Residual &residual, Precond &precond, const scalar_t *x,
+                             scalar_t x_norm, const scalar_t *v, scalar_t *Jv)
+        {
+            for_each(team, [&](size_t i) { Mv[i] = v[i]; });
+            precond.apply(team, Mv.data());
+            jacobian_vector(team, residual, x, x_norm, Mv.data(), Jv);
+        }
+
+        /*
+            restarted GMRES for J M^-1 z = -G with z = 0 as the initial guess, dx = M^-1 z;
+            returns the number of iterations
+        */
+        template<typename Residual, typename Precond>
+        size_t gmres(const execution::Team &team, Residual &residual, Precond &precond, const scalar_t *x, scalar_t G_norm) {
+            const size_t m = restart;
+            const scalar_t x_norm = norm(team, x);
+            const scalar_t target = krylov_rtol * G_norm;
+
+            std::vector<scalar_t> H((m + 1) * m), cs(m), sn(m), g(m + 1), y(m);
+            for_each(team, [&](size_t i) { dx[i] = 0.0; });
+
+            size_t iterations = 0;
+            scalar_t beta = G_norm;     // residual of dx = 0
+            while (iterations < max_krylov_iterations) {
+                // V0 = r / |r| with r = -G - J M^-1 z, z is accumulated in dx
+                if (iterations > 0) {
+                    operator_vector(team, residual, precond, x, x_norm, dx.data(), V[0].data());
+                    for_each(team, [&](size_t i) { V[0][i] = -G[i] - V[0][i]; });
+                    beta = norm(team, V[0].data());
+                } else {
+                    for_each(team, [&](size_t i) { V[0][i] = -G[i]; });
+                }
+                if (beta <= target) break;
+                for_each(team, [&](size_t i) { V[0][i] /= beta; });
+
+                std::fill(g.begin(), g.end(), 0.0);
+                g[0] = beta;
+
+                size_t j = 0;
+                for (; j < m && iterations < max_krylov_iterations; j++, iterations++) {
+                    scalar_t *w = V[j + 1].data();
+                    operator_vector(team, residual, precond, x, x_norm, V[j].data(), w);
+
+                    // modified Gram-Schmidt
+                    for (size_t i = 0; i <= j; i++) {
+                        scalar_t h = dot(team, w, V[i].data());
+                        H[i * m + j] = h;
+                        for_each(team, [&](size_t k) { w[k] -= h * V[i][k]; });
+                    }
+                    scalar_t h = norm(team, w);
+                    H[(j + 1) * m + j] = h;
+                    if (h > 0.0) for_each(team, [&](size_t k) { w[k] /= h; });
+
+                    // Givens rotations
+                    for (size_t i = 0; i < j; i++) {
+                        scalar_t t = cs[i] * H[i * m + j] + sn[i] * H[(i + 1) * m + j];
+                        H[(i + 1) * m + j] = -sn[i] * H[i * m + j] + cs[i] * H[(i + 1) * m + j];
+                        H[i * m + j] = t;
+                    }
+                    scalar_t r = std::hypot(H[j * m + j], H[(j + 1) * m + j]);
+                    cs[j] = H[j * m + j] / r;
+                    sn[j] = H[(j + 1) * m + j] / r;
+                    H[j * m + j] = r;
+                    H[(j + 1) * m + j] = 0.0;
+                    g[j + 1] = -sn[j] * g[j];
+                    g[j] = cs[j] * g[j];
+
+                    if (std::abs(g[j + 1]) <= target || h == 0.0) {
+                        j++;
+                        iterations++;
+                        break;
+                    }
+                }
+
+                // dx += V y with H y = g
+                for (size_t i = j; i-- > 0;) {
+                    y[i] = g[i];
+                    for (size_t k = i + 1; k < j; k++) y[i] -= H[i * m + k] * y[k];
+                    y[i] /= H[i * m + i];
+                }
+                for_each(team, [&](size_t k) {
+                    for (size_t i = 0; i < j; i++) dx[k] += y[i] * V[i][k];
+                });
+
+                if (std::abs(g[j]) <= target) break;
+            }
+            precond.apply(team, dx.data());
+            return iterations;
+        }
+
+    public:
+        scalar_t newton_rtol = 1e-6;            // |G| relative to its value at the initial guess
+        scalar_t newton_atol = 1e-12;
+        size_t max_newton_iterations = 10;
+
+        bool krylov = true;                     // false: dx = -M^-1 G without GMRES
+        scalar_t krylov_rtol = 1e-3;            // forcing term of the inexact Newton method
+        size_t restart = 30;
+        size_t max_krylov_iterations = 300;
+
+        size_t newton_iterations = 0;           // totals over all solves
+        size_t krylov_iterations = 0;
+        size_t failures = 0;                    // solves that did not converge
+
+        /*
+            solve residual(x) = 0 in place, starting from x. residual(team, x, G) writes the static
+            chunk of G(x) of its thread (`team.chunk(n)`) and may only read the same chunk of x
+            before its first barrier. Returns false if Newton did not converge.
+        */
+        template<typename Residual, typename Precond> requires (!std::is_pointer_v<std::remove_cvref_t<Precond>>)
+        bool solve(const execution::Team &team, scalar_t *x, size_t size, Residual &&residual, Precond &&precond,
+                   const mpi::Communicator *communicator = nullptr)
+        {
+            if (team.rank == 0 && (size != n || V.size() != restart + 1)) {
+                n = size;
+                V.assign(restart + 1, aligned_vec<scalar_t>(n));
+                G.resize(n); Gp.resize(n); dx.resize(n); xp.resize(n); Mv.resize(n);
+            }
+            if (team.rank == 0) comm = communicator;
+            team.sync();
+
+            residual(team, x, G.data());
+            const scalar_t G0 = norm(team, G.data());
+            scalar_t G_norm = G0;
+
+            bool converged = false;
+            size_t newton = 0, gmres_iterations = 0;
+            for (; newton < max_newton_iterations; newton++) {
+                if (G_norm <= newton_atol || G_norm <= newton_rtol * G0) {
+                    converged = true;
+                    break;
+                }
+                precond.setup(team, x);
+                if (krylov) {
+                    gmres_iterations += gmres(team, residual, precond, x, G_norm);
+                } else {
+                    for_each(team, [&](size_t i) { dx[i] = -G[i]; });
+                    precond.apply(team, dx.data());
+                }
+                for_each(team, [&](size_t i) { x[i] += dx[i]; });
+                residual(team, x, G.data());
+                G_norm = norm(team, G.data());
+            }
+            converged = converged || G_norm <= newton_atol || G_norm <= newton_rtol * G0;
+
+            // the caller synchronizes before the counters are read
+            if (team.rank == 0) {
+                newton_iterations += newton;
+                krylov_iterations += gmres_iterations;
+                if (!converged) failures++;
+            }
+            return converged;
+        }
+
+        template<typename Residual>
+        bool solve(const execution::Team &team, scalar_t *x, size_t size, Residual &&residual,
+                   const mpi::Communicator *communicator = nullptr)
+        {
+            return solve(team, x, size, residual, Identity{}, communicator);
+        }
+    };
+}
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <DG.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "core/parallel.hpp"
+#include "integrator.hpp"
+#include "mesh/mesh.hpp"
+
+namespace DG::integrator::steady {
+
+    /*
+        solvers that march to a steady state instead of advancing in time
+    */
+    template<typename tSolver>
+    inline constexpr bool is_steady = requires { requires tSolver::steady; };
+
+    /**
+     * @brief p-multigrid accelerated pseudo-time stepping to a steady state L(u) = 0
+     *
+     * The smoother is the three-stage SSP Runge-Kutta scheme in pseudo time with the CFL step
+     * of every cell instead of the global minimum, so it only damps the residual and is not
+     * time accurate. The smoothing is accelerated by a nonlinear (FAS) V-cycle over the
+     * polynomial orders p, p-1, ..., 1: every coarse level is an integrator of the same mesh
+     * with the lower order, and the transfer operators truncate or pad the modal Legendre
+     * coefficients of the cell, u_modal = V^-1 u with the Vandermonde matrix of RefCell. The
+     * coarse level l solves L_l(u_l) + s_l = 0, where the forcing
+     *
+     *      s_l = R (L_l-1(u_l-1) + s_l-1) - L_l(R u_l-1)
+     *
+     * makes R u_l-1 its solution when the finer level is converged. `history` holds the RMS
+     * norm of L(u) at the start of every cycle.
+     */
+    template<typename Integrator>
+    class PMultigrid {
+    private:
+        using Model = typename Integrator::model_t;
+        using coarse_t = integrator::Integrator<Model, typename Integrator::flux_t>;
+
+        std::vector<coarse_t> coarse;       // orders p-1, p-2, ...
+        std::vector<mat_t> R, P;            // restriction and prolongation from level l to l+1 and back
+        std::vector<aligned_vec<scalar_t>> s;       // forcing of the coarse levels
+        std::vector<aligned_vec<scalar_t>> u_R;     // restricted fine state of the coarse levels
+
+        // the rms norm of the finest residual in the current cycle
+        scalar_t norm = 0.0;
+
+        /*
+            u_to = T u_from on every cell of the team, T is (Nnodes_to x Nnodes_from)
+        */
+        static void transfer(const execution::Team &team, const mat_t &T, size_t NC, const scalar_t *u_from, scalar_t *u_to) {
+            constexpr size_t NE = Model::NumEqns;
+            const size_t n_to = T.rows();
+            const size_t n_from = T.cols();
+
+            auto [begin, end] = team.chunk(NC);
+            for (size_t c = begin; c < end; c++) {
+                const scalar_t *from = u_from + c * n_from * NE;
+                scalar_t *to = u_to + c * n_to * NE;
+                for (size_t i = 0; i < n_to; i++) {
+                    for (size_t k = 0; k < NE; k++) {
+                        scalar_t sum = 0.0;
+                        for (size_t j = 0; j < n_from; j++) {
+                            sum += T(i, j) * from[j * NE + k];
+                        }
+                        to[i * NE + k] = sum;
+                    }
+                }
+            }
+        }
+
+        // dudt = L(u) + forcing for the current u of the level
+        void residual(const execution::Team &team, auto &level, const scalar_t *forcing) {
+            team.sync();
+            level.compute_rhs(team);
+            team.sync();
+            if (!forcing) return;
+
+            const size_t stride = level.field.stride();
+            auto [begin, end] = team.chunk(level.field.Ncells);
+            for (size_t i = begin * stride; i < end * stride; i++) {
+                level.field.dudt[i] += forcing[i];
+            }
+        }
+
+        /*
+            pseudo-time steps of one level with the CFL step of every cell; with `monitor`, the
+            rms norm of the first residual is stored in `norm`
+        */
+        void smooth(const execution::Team &team, auto &level, const scalar_t *forcing, size_t steps, bool monitor) {
+            const size_t NC = level.field.Ncells;
+            const size_t stride = level.field.stride();
+            scalar_t *u = level.field.u.data();
+            scalar_t *u0 = level.field.u0.data();
+            const scalar_t *dudt = level.field.dudt.data();
+
+            auto [begin, end] = team.chunk(NC);
+            std::vector<scalar_t> dtau(end - begin);
+
+            for (size_t step = 0; step < steps; step++) {
+                // compute_dt reads the primitive variables
+                team.sync();
+                level.update_primitive(team);
+                team.sync();
+                for (size_t c = begin; c < end; c++) {
+                    dtau[c - begin] = level.compute_dt(c);
+                }
+                for (size_t i = begin * stride; i < end * stride; i++) u0[i] = u[i];
+
+                for (size_t stage = 0; stage < 3; stage++) {
+                    residual(team, level, forcing);
+
+                    if (monitor && step == 0 && stage == 0) {
+                        scalar_t sum = 0.0;
+                        for (size_t i = begin * stride; i < end * stride; i++) sum += dudt[i] * dudt[i];
+                        sum = team.reduce(sum, [](scalar_t a, scalar_t b) { return a + b; });
+                        scalar_t count = NC * stride;
+                        if (level.comm.size() > 1) {
+                            if (team.rank == 0) {
+                                sum = level.comm.allreduce_sum(sum);
+                                count = level.comm.allreduce_sum(count);
+                            }
+                            sum = team.broadcast(sum);
+                            count = team.broadcast(count);
+                        }
+                        if (team.rank == 0) norm = std::sqrt(sum / count);
+                    }
+
+                    for (size_t c = begin; c < end; c++) {
+                        const scalar_t dt = dtau[c - begin];
+                        for (size_t i = c * stride; i < (c + 1) * stride; i++) {
+                            if (stage == 0) {
+                                u[i] = u0[i] + dt * dudt[i];
+                            } else if (stage == 1) {
+                                u[i] = 0.75 * u0[i] + 0.25 * (u[i] + dt * dudt[i]);
+                            } else {
+                                u[i] = 1.0 / 3.0 * u0[i] + 2.0 / 3.0 * (u[i] + dt * dudt[i]);
+                            }
+                        }
+                    }
+                }
+            }
+            team.sync();
+        }
+
+        /*
+            V-cycle from level l; the finest level runs with the team of the integrator, the
+            coarse levels with static chunks (they have no cost model for work stealing)
+        */
+        void v_cycle(const execution::Team &team, const execution::Team &coarse_team, auto &level, size_t l) {
+            const execution::Team &level_team = (l == 0) ? team : coarse_team;
+            const scalar_t *forcing = (l > 0) ? s[l - 1].data() : nullptr;
+
+            if (l == coarse.size()) {
+                smooth(level_team, level, forcing, coarse_smoothing, l == 0);
+                return;
+            }
+            smooth(level_team, level, forcing, pre_smoothing, l == 0);
+
+            coarse_t &next = coarse[l];
+            const size_t NC = level.field.Ncells;
+            const size_t stride = next.field.stride();
+            auto [begin, end] = coarse_team.chunk(NC);
+
+            // R u and R (L(u) + s) of the smoothed state
+            residual(level_team, level, forcing);
+            transfer(coarse_team, R[l], NC, level.field.u.data(), next.field.u.data());
+            transfer(coarse_team, R[l], NC, level.field.dudt.data(), s[l].data());
+
+            // s_l+1 = R r - L_l+1(R u)
+            residual(coarse_team, next, nullptr);
+            for (size_t i = begin * stride; i < end * stride; i++) {
+                s[l][i] -= next.field.dudt[i];
+                u_R[l][i] = next.field.u[i];
+            }
+
+            v_cycle(team, coarse_team, next, l + 1);
+
+            // u += P (u_l+1 - R u)
+            for (size_t i = begin * stride; i < end * stride; i++) {
+                next.field.u0[i] = next.field.u[i] - u_R[l][i];
+            }
+            transfer(coarse_team, P[l], NC, next.field.u0.data(), level.field.dudt.data());
+            const size_t fine_stride = level.field.stride();
+            for (size_t i = begin * fine_stride; i < end * fine_stride; i++) {
+                level.field.u[i] += level.field.dudt[i];
+            }
+
+            smooth(level_team, level, forcing, post_smoothing, false);
+        }
+
+    public:
+        static constexpr bool steady = true;
+
+        size_t pre_smoothing = 1;       // pseudo-time steps before and after the coarse correction
+        size_t post_smoothing = 1;
+        size_t coarse_smoothing = 4;    // pseudo-time steps of the coarsest level
+
+        scalar_t rtol = 1e-8;           // residual norm relative to the first cycle
+        scalar_t atol = 1e-12;
+        size_t max_cycles = 10000;
+
+        std::vector<scalar_t> history;  // residual norm at the start of every cycle
+
+        /*
+            levels - 1 coarse levels of the order of `fine` on its mesh, down to p = 1; levels = 1
+            is plain local pseudo-time stepping
+        */
+        PMultigrid(Integrator &fine, mesh::Mesh<Model::NumDims> &mesh, size_t levels = 0) {
+            const size_t porder = fine.porder;
+            if (levels == 0 || levels > porder) levels = std::max<size_t>(porder, 1);
+
+            // the coarse levels keep the stability margin of the fine one: the explicit limit
+            // scales as dx / (2p + 1), the CFL step of the integrator as dx / max(p - 1, 1)^2
+            auto scale = [](scalar_t p) { return std::pow(std::max<scalar_t>(p - 1, 1.0), 2) / (2 * p + 1); };
+
+            const RefCell *ref = &fine.ref_cell;
+            for (size_t l = 1; l < levels; l++) {
+                const scalar_t p = porder - l;
+                coarse.emplace_back(mesh, fine.scene, porder - l, fine.cfl * scale(p) / scale(porder));
+            }
+
+            for (size_t l = 0; l + 1 < levels; l++) {
+                const RefCell &c = coarse[l].ref_cell;
+                const size_t nf = ref->n;
+                const size_t nc = c.n;
+
+                // drop the modes above the coarse order, or add them with zero coefficients
+                mat_t Vf_inv = ref->V.inv();
+                mat_t Vc_inv = c.V.inv();
+                mat_t Rl(nc, nf), Pl(nf, nc);
+                for (size_t i = 0; i < nc; i++) {
+                    for (size_t j = 0; j < nf; j++) {
+                        scalar_t sum = 0.0;
+                        for (size_t m = 0; m < nc; m++) sum += c.V(i, m) * Vf_inv(m, j);
+                        Rl(i, j) = sum;
+                    }
+                }
+                for (size_t i = 0; i < nf; i++) {
+                    for (size_t j = 0; j < nc; j++) {
+                        scalar_t sum = 0.0;
+                        for (size_t m = 0; m < nc; m++) sum += ref->V(i, m) * Vc_inv(m, j);
+                        Pl(i, j) = sum;
+                    }
+                }
+                R.push_back(Rl);
+                P.push_back(Pl);
+
+                s.emplace_back(coarse[l].field.u.size());
+                u_R.emplace_back(coarse[l].field.u.size());
+                ref = &c;
+            }
+
+            // the smoother and the transfers work on dudt and u0 of every level
+            fine.field.reserve(Registers::RHS | Registers::U0);
+            for (auto &c : coarse) c.field.reserve(Registers::RHS | Registers::U0);
+        }
+
+        size_t levels() const {
+            return coarse.size() + 1;
+        }
+
+        /*
+            one V-cycle, returns the residual norm of u before the cycle
+        */
+        scalar_t cycle(Integrator &integrator, const execution::Team &team) {
+            execution::Team coarse_team = team;
+            coarse_team.stealer = nullptr;
+
+            v_cycle(team, coarse_team, integrator, 0);
+            const scalar_t r = norm;
+            if (team.rank == 0) history.push_back(r);
+            team.sync();
+            return r;
+        }
+
+        scalar_t cycle(Integrator &integrator) {
+            scalar_t r = 0.0;
+            integrator.run_team([&](const execution::Team &team) {
+                scalar_t r_team = cycle(integrator, team);
+                if (team.rank == 0) r = r_team;
+            });
+            return r;
+        }
+
+        // the residual norm of the last cycle is below rtol times the first one, or below atol
+        bool converged() const {
+            return !history.empty() && (history.back() <= atol || history.back() <= rtol * history.front());
+        }
+    };
+}
@@ -2,25 +2,77 @@
 
 #include "core/types.hpp"
 #include <DG.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "core/blockTridiagonal.hpp"
+#include "core/parallel.hpp"
+#include "newtonKrylov.hpp"
 
 namespace DG::integrator::time {
+    /*
+        f(i) for every value of the state registers in the cells of the team thread
+    */
+    inline void for_each_value(auto &integrator, const execution::Team &team, auto &&f) {
+        const size_t s = integrator.field.stride();
+        team.for_each(integrator.field.Ncells, [&](size_t begin, size_t end) {
+            for (size_t i = begin * s; i < end * s; i++) {
+                f(i);
+            }
+        });
+    }
+
+    /*
+        right hand side, a stage update on the owned cells, and a barrier before the
+        next stage reads the neighbours
+
+        integrator.time is the time of the stage; it becomes t_next, the time of the next
+        stage, before the barrier. The boundary conditions only read it in the face fluxes,
+        which all threads have completed when the right hand side returns.
+    */
+    inline void stage(auto &integrator, const execution::Team &team, scalar_t t_next, auto &&update) {
+        integrator.compute_rhs(team);
+        for_each_value(integrator, team, update);
+        if (team.rank == 0) integrator.time = t_next;
+        team.sync();
+    }
+
+    /*
+        the same with the fused stage kernel of the integrator: update(i, dudt_i) is applied
+        while the right hand side of a cell packet is in cache, dudt is never stored
+    */
+    inline void fused_stage(auto &integrator, const execution::Team &team, scalar_t t_next, auto &&update) {
+        integrator.compute_stage(team, update);
+        if (team.rank == 0) integrator.time = t_next;
+        team.sync();
+    }
+
     /**
      * @brief Second-order Runge-Kutta method
      * 
      */
     struct RK2 {
-        void advance(auto &integrator, scalar_t dt) {
+        void advance(auto &integrator, scalar_t dt, const execution::Team &team) {
+            integrator.reserve(team, Registers::U0);
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *u0 = integrator.field.u0.data();
+            const scalar_t t = integrator.time;
 
-            integrator.compute_flux();
-            for (auto &cell : integrator.cells) {
-                cell.u0 = cell.u;
-                cell.u += integrator.dudt(cell) * dt * 0.5;
-            }
+            fused_stage(integrator, team, t + dt * 0.5, [&](size_t i, scalar_t dudt) {
+                u0[i] = u[i];
+                u[i] += dudt * dt * 0.5;
+            });
 
-            integrator.compute_flux();
-            for (auto &cell : integrator.cells) {
-                cell.u = cell.u0 + integrator.dudt(cell) * dt;
-            }
+            fused_stage(integrator, team, t + dt, [&](size_t i, scalar_t dudt) {
+                u[i] = u0[i] + dudt * dt;
+            });
+        }
+
+        void advance(auto &integrator, scalar_t dt) {
+            integrator.run_team([&](const execution::Team &team) { advance(integrator, dt, team); });
         }
     };
 
@@ -29,29 +81,686 @@ namespace DG::integrator::time {
      * 
      */
     struct SSP_RK3 {
+        void advance(auto &integrator, scalar_t dt, const execution::Team &team) {
+            integrator.reserve(team, Registers::U0);
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *u0 = integrator.field.u0.data();
+            const scalar_t t = integrator.time;
+
+            fused_stage(integrator, team, t + dt, [&](size_t i, scalar_t dudt) {
+                u0[i] = u[i];
+                u[i] += dudt * dt;
+            });
+
+            fused_stage(integrator, team, t + dt * 0.5, [&](size_t i, scalar_t dudt) {
+                u[i] = u0[i] * 0.75 + u[i] * 0.25 + dudt * dt * 0.25;
+            });
+
+            fused_stage(integrator, team, t + dt, [&](size_t i, scalar_t dudt) {
+                u[i] = (u0[i] + u[i] * 2.0 + dudt * dt * 2.0) / 3.0;
+            });
+        }
+
         void advance(auto &integrator, scalar_t dt) {
-            integrator.compute_flux();
-            for (auto &cell : integrator.cells) {
-                cell.u0 = cell.u;
-                cell.u += integrator.dudt(cell) * dt;
+            integrator.run_team([&](const execution::Team &team) { advance(integrator, dt, team); });
+        }
+    };
+
+    /**
+     * @brief Five stage low storage Fourth-order Runge-Kutta method
+     *
+     * 2N-storage scheme of Carpenter and Kennedy (1994): only u and the residual register
+     * (field.dudt) are used, u0 is never allocated (the primitive variables p of the field
+     * stay, they are read by the time step).
+     *
+     *      r = A[s] * r + dt * L(u)
+     *      u = u + B[s] * r
+     */
+    struct LS_RK4 {
+        static constexpr size_t NumStages = 5;
+
+        static constexpr scalar_t A[NumStages] = {
+            0.0,
+            -567301805773.0 / 1357537059087.0,
+            -2404267990393.0 / 2016746695238.0,
+            -3550918686646.0 / 2091501179385.0,
+            -1275806237668.0 / 842570457699.0
+        };
+
+        static constexpr scalar_t B[NumStages] = {
+            1432997174477.0 / 9575080441755.0,
+            5161836677717.0 / 13612068292357.0,
+            1720146321549.0 / 2090206949498.0,
+            3134564353537.0 / 4481467310338.0,
+            2277821191437.0 / 14882151754819.0
+        };
+
+        // stage times, the last entry is the end of the step
+        static constexpr scalar_t C[NumStages + 1] = {
+            0.0,
+            1432997174477.0 / 9575080441755.0,
+            2526269341429.0 / 6820363962896.0,
+            2006345519317.0 / 3224310063776.0,
+            2802321613138.0 / 2924317926251.0,
+            1.0
+        };
+
+        void advance(auto &integrator, scalar_t dt, const execution::Team &team) {
+            integrator.reserve(team, Registers::DUDT);
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *r = integrator.field.dudt.data();
+            const scalar_t t = integrator.time;
+
+            // A[0] = 0, the residual of the previous step is not read
+            fused_stage(integrator, team, t + C[1] * dt, [&](size_t i, scalar_t dudt) {
+                r[i] = dudt * dt;
+                u[i] += B[0] * r[i];
+            });
+
+            for (size_t s = 1; s < NumStages; s++) {
+                fused_stage(integrator, team, (s + 1 < NumStages) ? t + C[s + 1] * dt : t + dt, [&](size_t i, scalar_t dudt) {
+                    r[i] = A[s] * r[i] + dudt * dt;
+                    u[i] += B[s] * r[i];
+                });
             }
+        }
+
+        void advance(auto &integrator, scalar_t dt) {
+            integrator.run_team([&](const execution::Team &team) { advance(integrator, dt, team); });
+        }
+    };
+
+    /*
+        adaptive solvers choose their own dt, see `Driver::time_loop`
+    */
+    template<typename tSolver>
+    inline constexpr bool is_adaptive = requires { requires tSolver::adaptive; };
 
-            integrator.compute_flux();
-            for (auto &cell : integrator.cells) {
-                cell.u = cell.u0 * 0.75 + cell.u * 0.25 + integrator.dudt(cell) * dt * 0.25;
+    /*
+        solvers with a time step per cell, they apply the CFL condition themselves
+    */
+    template<typename tSolver>
+    inline constexpr bool is_local = requires { requires tSolver::local; };
+
+    /**
+     * @brief Bogacki-Shampine 3(2) embedded pair with a PI step size controller
+     *
+     * `step` advances by one accepted step of at most dt_max (the CFL limit) and returns its
+     * size. The error of the embedded second-order solution is measured in the max norm
+     * relative to atol + rtol * |u|; steps with an error above one are rejected and repeated
+     * with a smaller dt. The last stage is the first stage of the next step (FSAL), which also
+     * survives a rejection, so a step costs three evaluations of the right hand side.
+     *
+     * Registers: u, u0 and three of the solver, k (FSAL stage), acc (partial sum, then the
+     * last stage) and err. The controller state is shared by the team, it is only written by
+     * the first thread between barriers.
+     */
+    class BS3 {
+    private:
+
+        aligned_vec<scalar_t> k[2];     // k[cur]: stage 1 of the next step
+        aligned_vec<scalar_t> err;
+        size_t cur = 0;
+
+        scalar_t dt_next = 0.0;         // proposed size of the next step, 0: dt_max
+        scalar_t err_prev = 1.0;
+        bool fsal = false;              // k[cur] holds the right hand side of u
+
+        // max over the threads and the ranks
+        scalar_t error_norm(auto &integrator, const execution::Team &team, scalar_t err_local) {
+            scalar_t err_norm = team.reduce(err_local, [](scalar_t a, scalar_t b) { return std::max(a, b); });
+            if (integrator.comm.size() > 1) {
+                if (team.rank == 0) err_norm = integrator.comm.allreduce_max(err_norm);
+                err_norm = team.broadcast(err_norm);
             }
+            return err_norm;
+        }
+
+    public:
+        static constexpr bool adaptive = true;
+        static constexpr size_t Order = 3;
+
+        scalar_t rtol = 1e-6;
+        scalar_t atol = 1e-6;
+
+        scalar_t safety = 0.9;
+        scalar_t fac_min = 0.2;     // bounds of the step size ratio
+        scalar_t fac_max = 5.0;
+        scalar_t alpha = 0.7 / Order;   // PI gains, Hairer & Wanner
+        scalar_t beta  = 0.4 / Order;
+
+        size_t accepted = 0;
+        size_t rejected = 0;
+
+        BS3() = default;
+        BS3(scalar_t rtol, scalar_t atol) : rtol(rtol), atol(atol) {}
+
+        // forget the step size history and the FSAL stage, e.g. after changing u by hand
+        void reset() {
+            dt_next = 0.0;
+            err_prev = 1.0;
+            fsal = false;
+        }
+
+        scalar_t step(auto &integrator, scalar_t dt_max, const execution::Team &team) {
+            const size_t n = integrator.field.u.size();
+            if (team.rank == 0 && err.size() != n) {
+                for (auto &r : k) r.resize(n);
+                err.resize(n);
+                reset();
+            }
+            team.sync();
+            integrator.reserve(team, Registers::U0);
+
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *u0 = integrator.field.u0.data();
+            scalar_t *k1 = k[cur].data();
+            scalar_t *acc = k[cur ^ 1].data();
+            scalar_t *e = err.data();
 
-            integrator.compute_flux();
-            for (auto &cell : integrator.cells) {
-                cell.u = (cell.u0 + cell.u * 2.0 + integrator.dudt(cell) * dt * 2.0) / 3.0;
+            const scalar_t t = integrator.time;
+            scalar_t dt = (dt_next > 0.0) ? std::min(dt_next, dt_max) : dt_max;
+            const scalar_t dt_proposed = dt_next;
+            bool have_k1 = fsal;
+            size_t nrejected = 0;
+
+            while (true) {
+                // stage 1 at u^n, reused from the last step if possible
+                auto stage1 = [&](size_t i, scalar_t dudt) {
+                    k1[i] = dudt;
+                    u0[i] = u[i];
+                    acc[i] = dudt * (2.0 / 9.0);
+                    e[i] = dudt * (-5.0 / 72.0);
+                    u[i] = u0[i] + dudt * dt * 0.5;
+                };
+                if (have_k1) {
+                    for_each_value(integrator, team, [&](size_t i) { stage1(i, k1[i]); });
+                    if (team.rank == 0) integrator.time = t + dt * 0.5;
+                    team.sync();
+                } else {
+                    fused_stage(integrator, team, t + dt * 0.5, stage1);
+                }
+
+                fused_stage(integrator, team, t + dt * 0.75, [&](size_t i, scalar_t dudt) {
+                    acc[i] += dudt * (1.0 / 3.0);
+                    e[i] += dudt * (1.0 / 12.0);
+                    u[i] = u0[i] + dudt * dt * 0.75;
+                });
+
+                fused_stage(integrator, team, t + dt, [&](size_t i, scalar_t dudt) {
+                    e[i] += dudt * (1.0 / 9.0);
+                    u[i] = u0[i] + (acc[i] + dudt * (4.0 / 9.0)) * dt;
+                });
+
+                // stage 4 at u^n+1, the max is independent of the order of the cells
+                scalar_t err_local = 0.0;
+                fused_stage(integrator, team, t + dt, [&](size_t i, scalar_t dudt) {
+                    acc[i] = dudt;
+                    scalar_t sc = atol + rtol * std::max(std::abs(u0[i]), std::abs(u[i]));
+                    err_local = std::max(err_local, std::abs((e[i] - dudt * 0.125) * dt) / sc);
+                });
+                scalar_t err_norm = error_norm(integrator, team, err_local);
+
+                if (err_norm <= 1.0) {
+                    // PI controller, err_prev of the last accepted step
+                    err_norm = std::max(err_norm, 1e-10);
+                    scalar_t fac = safety * std::pow(err_norm, -alpha) * std::pow(err_prev, beta);
+                    fac = std::clamp(fac, fac_min, nrejected ? 1.0 : fac_max);     // no growth right after a rejection
+                    if (team.rank == 0) {
+                        // a step shortened by dt_max does not shrink the next one
+                        dt_next = (nrejected == 0 && dt < dt_proposed) ? std::max(dt * fac, dt_proposed) : dt * fac;
+                        err_prev = err_norm;
+                        fsal = true;
+                        cur ^= 1;
+                        accepted++;
+                        rejected += nrejected;
+                    }
+                    team.sync();
+                    return dt;
+                }
+
+                // reject: restore u^n, its stage 1 is still in k1
+                for_each_value(integrator, team, [&](size_t i) { u[i] = u0[i]; });
+                if (team.rank == 0) integrator.time = t;
+                team.sync();
+                scalar_t fac = std::max(fac_min, safety * std::pow(err_norm, -1.0 / Order));
+                dt *= std::min(fac, 1.0);
+                have_k1 = true;
+                nrejected++;
             }
         }
+
+        scalar_t step(auto &integrator, scalar_t dt_max) {
+            scalar_t dt = 0.0;
+            integrator.run_team([&](const execution::Team &team) {
+                scalar_t dt_team = step(integrator, dt_max, team);
+                if (team.rank == 0) dt = dt_team;
+            });
+            return dt;
+        }
     };
 
     /**
-     * @brief Five stage low storage Fourth-order Runge-Kutta method
+     * @brief local time stepping with power-of-two levels, SSP_RK3 on every level
+     *
+     * Every macro step the cells are grouped by their CFL time step: a cell of level k advances
+     * with 2^k * dt_min, where dt_min is the smallest CFL step of all cells and k < max_levels.
+     * The macro step is the step of the coarsest level K, split into 2^K micro steps. At every
+     * micro step the levels that start a step are advanced from the coarsest to the finest; in
+     * the stages of a cell, a finer neighbour is taken at the start of the step (it has not
+     * moved yet) and a coarser one is interpolated linearly in time between its u0 and u.
+     *
+     * Every cell accumulates the time integral of the fluxes at its two faces. When the
+     * coarser cell of a face between two levels completes its step, its flux integral is
+     * replaced by the one of the finer neighbour (refluxing), so both cells exchange the same
+     * flux and the scheme is conservative.
+     *
+     * The frozen and interpolated traces make the coupling of the levels second order in time,
+     * so on more than one level the scheme converges at second order instead of the third of
+     * SSP_RK3.
+     *
+     * `step` returns the macro step, at most dt_max. Partitioned meshes are not supported.
      */
-    struct LS_RK4 {
+    class LTS {
+    private:
+
+        static constexpr size_t NoCell = std::numeric_limits<size_t>::max();
+
+        std::vector<scalar_t> dt_cell;              // CFL time step of every cell
+        std::vector<size_t> level;
+        std::vector<std::vector<size_t>> cells;     // cells of every level
+        std::vector<std::vector<size_t>> boundary;  // boundary faces of every level, increasing indices into integrator.boundary_faces
+        std::vector<scalar_t> flux_int;             // [cell][L/R][eqn], flux integral since the face was synchronized
+
+        /* SSP_RK3 stages: times and weights of the stage fluxes in the step */
+        static constexpr scalar_t c[3] = {0.0, 1.0, 0.5};
+        static constexpr scalar_t b[3] = {1.0 / 6.0, 1.0 / 6.0, 2.0 / 3.0};
+
+        // neighbour of cell i at side (L/R), NoCell at a boundary
+        size_t neighbour(const auto &integrator, size_t i, size_t side) const {
+            const auto &face = integrator.faces[integrator.cell_faces[i][side]];
+            if (side == L) return (face.loc == FaceLocation::LEFT) ? NoCell : face.im;
+            return (face.loc == FaceLocation::RIGHT) ? NoCell : face.ip;
+        }
+
+        /*
+            refluxing at micro step m, for the cells that complete a step: the coarser cell of a
+            face between two levels takes the flux integral of its finer neighbour; then the flux
+            integrals of the synchronized faces restart
+        */
+        void synchronize(auto &integrator, const execution::Team &team, size_t m, size_t K) {
+            constexpr size_t NE = std::remove_reference_t<decltype(integrator)>::model_t::NumEqns;
+            const size_t NP = integrator.field.Nnodes;
+            const scalar_t *lift[2] = {integrator.lift(L), integrator.lift(R)};
+
+            for (size_t pass = 0; pass < 2; pass++) {
+                for (size_t k = 0; k <= K; k++) {
+                    if (m % (size_t(1) << k)) continue;
+                    auto [begin, end] = team.chunk(cells[k].size());
+                    for (size_t n = begin; n < end; n++) {
+                        const size_t i = cells[k][n];
+                        for (size_t side : {L, R}) {
+                            const size_t nb = neighbour(integrator, i, side);
+                            if (nb == NoCell) continue;
+                            if (m % (size_t(1) << std::max(k, level[nb]))) continue;    // face not synchronized
 
+                            scalar_t *own = flux_int.data() + (2 * i + side) * NE;
+                            if (pass == 1) {
+                                for (size_t e = 0; e < NE; e++) own[e] = 0.0;
+                                continue;
+                            }
+                            if (level[nb] >= k) continue;
+
+                            // u -= lift * (f_nb - f_own) / detJ, summed over the step
+                            const scalar_t *other = flux_int.data() + (2 * nb + (side == L ? R : L)) * NE;
+                            scalar_t *u = integrator.field.u.data() + i * integrator.field.stride();
+                            for (size_t j = 0; j < NP; j++) {
+                                for (size_t e = 0; e < NE; e++) {
+                                    u[j * NE + e] += lift[side][j] * (own[e] - other[e]) / integrator.field.detJ[i];
+                                }
+                            }
+                        }
+                    }
+                }
+                team.sync();
+            }
+        }
+
+        /*
+            one SSP_RK3 step of the cells of level k, starting at micro step m of size dt_micro
+        */
+        void advance_level(auto &integrator, const execution::Team &team, size_t k, size_t m, scalar_t dt_micro) {
+            using model_t = typename std::remove_reference_t<decltype(integrator)>::model_t;
+            using var_t = typename model_t::var_t;
+            constexpr size_t NE = model_t::NumEqns;
+            const size_t NP = integrator.field.Nnodes;
+            const size_t stride = integrator.field.stride();
+            const scalar_t dt = dt_micro * (size_t(1) << k);
+
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *u0 = integrator.field.u0.data();
+            scalar_t *dudt = integrator.field.dudt.data();
+
+            // trace of neighbour nb at node j and micro time t
+            auto trace = [&](size_t nb, size_t j, scalar_t t) {
+                var_t v;
+                const size_t l = level[nb];
+                const scalar_t *un = u + nb * stride + j * NE;
+                const scalar_t *u0n = u0 + nb * stride + j * NE;
+                if (l > k) {
+                    const size_t start = (m >> l) << l;
+                    const scalar_t theta = (t - start) / (size_t(1) << l);
+                    for (size_t e = 0; e < NE; e++) v[e] = u0n[e] + theta * (un[e] - u0n[e]);
+                } else {
+                    for (size_t e = 0; e < NE; e++) v[e] = un[e];
+                }
+                return v;
+            };
+
+            // numerical flux of face f, stored by compute_boundary_fluxes
+            auto stored_flux = [&](size_t f) {
+                var_t flux;
+                for (size_t e = 0; e < NE; e++) flux[e] = integrator.field.f_face[f * NE + e];
+                return flux;
+            };
+
+            scalar_t *scratch = integrator.field.scratch[team.rank].data();
+            auto [begin, end] = team.chunk(cells[k].size());
+
+            for (size_t s = 0; s < 3; s++) {
+                const scalar_t t = m + c[s] * (size_t(1) << k);
+                const scalar_t time = integrator.time + t * dt_micro;     // of the boundary conditions
+
+                // boundary faces of the level, one dispatch of their condition per run of faces
+                if (!boundary[k].empty()) {
+                    auto [fb, fe] = team.chunk(boundary[k].size());
+                    integrator.compute_boundary_fluxes(fe - fb, [&](size_t j) { return boundary[k][fb + j]; }, time);
+                    team.sync();
+                }
+
+                for (size_t n = begin; n < end; n++) {
+                    const size_t i = cells[k][n];
+                    const scalar_t *ui = u + i * stride;
+                    var_t own_L, own_R;
+                    for (size_t e = 0; e < NE; e++) {
+                        own_L[e] = ui[e];
+                        own_R[e] = ui[(NP - 1) * NE + e];
+                    }
+
+                    const size_t nb_L = neighbour(integrator, i, L);
+                    const size_t nb_R = neighbour(integrator, i, R);
+                    const size_t face_L = integrator.cell_faces[i][L];
+                    const size_t face_R = integrator.cell_faces[i][R];
+                    var_t f_L = (nb_L == NoCell) ? stored_flux(face_L) : integrator.face_flux(face_L, trace(nb_L, NP - 1, t), own_L);
+                    var_t f_R = (nb_R == NoCell) ? stored_flux(face_R) : integrator.face_flux(face_R, own_R, trace(nb_R, 0, t));
+
+                    scalar_t *int_L = flux_int.data() + (2 * i + L) * NE;
+                    scalar_t *int_R = flux_int.data() + (2 * i + R) * NE;
+                    for (size_t e = 0; e < NE; e++) {
+                        int_L[e] += b[s] * dt * f_L[e];
+                        int_R[e] += b[s] * dt * f_R[e];
+                    }
+
+                    integrator.compute_cell_rhs(i, f_L.data(), f_R.data(), scratch, dudt + i * stride);
+                }
+                team.sync();
+
+                for (size_t n = begin; n < end; n++) {
+                    const size_t i0 = cells[k][n] * stride;
+                    for (size_t i = i0; i < i0 + stride; i++) {
+                        if (s == 0) {
+                            u0[i] = u[i];
+                            u[i] += dudt[i] * dt;
+                        } else if (s == 1) {
+                            u[i] = u0[i] * 0.75 + u[i] * 0.25 + dudt[i] * dt * 0.25;
+                        } else {
+                            u[i] = (u0[i] + u[i] * 2.0 + dudt[i] * dt * 2.0) / 3.0;
+                        }
+                    }
+                }
+                team.sync();
+            }
+        }
+
+    public:
+        static constexpr bool adaptive = true;
+        static constexpr bool local = true;
+
+        size_t max_levels = 8;      // largest ratio of the cell time steps is 2^(max_levels - 1)
+
+        size_t rhs_evaluations = 0; // cell right hand sides, of all stages so far
+
+        LTS() = default;
+        LTS(size_t max_levels) : max_levels(max_levels) {}
+
+        scalar_t step(auto &integrator, scalar_t dt_max, const execution::Team &team) {
+            constexpr size_t NE = std::remove_reference_t<decltype(integrator)>::model_t::NumEqns;
+            const size_t N = integrator.field.Ncells;
+            assert(integrator.comm.size() == 1 && "Local time stepping on a partitioned mesh.");
+            integrator.reserve(team, Registers::DUDT | Registers::U0);
+
+            if (team.rank == 0 && level.size() != N) {
+                dt_cell.resize(N);
+                level.resize(N);
+                flux_int.resize(2 * N * NE);
+            }
+            team.sync();
+
+            // CFL time steps of the current state, levels and the macro step
+            integrator.update_primitive(team);
+            auto [begin, end] = team.chunk(N);
+            scalar_t dt_min = std::numeric_limits<scalar_t>::max();
+            for (size_t i = begin; i < end; i++) {
+                dt_cell[i] = integrator.compute_dt(i);
+                dt_min = std::min(dt_min, dt_cell[i]);
+            }
+            dt_min = team.reduce(dt_min, [](scalar_t a, scalar_t b) { return std::min(a, b); });
+
+            scalar_t K_local = 0;
+            for (size_t i = begin; i < end; i++) {
+                size_t k = 0;
+                while (k + 1 < max_levels && dt_cell[i] >= dt_min * (size_t(2) << k)) k++;
+                level[i] = k;
+                std::fill_n(flux_int.data() + 2 * i * NE, 2 * NE, 0.0);
+                K_local = std::max<scalar_t>(K_local, k);
+            }
+            const size_t K = team.reduce(K_local, [](scalar_t a, scalar_t b) { return std::max(a, b); });
+
+            const size_t M = size_t(1) << K;
+            scalar_t dt_micro = std::min(dt_min, dt_max / M);
+
+            if (team.rank == 0) {
+                cells.assign(K + 1, {});
+                for (size_t i = 0; i < N; i++) {
+                    cells[level[i]].push_back(i);
+                    rhs_evaluations += 3 * (M >> level[i]);
+                }
+                boundary.assign(K + 1, {});
+                for (size_t j = 0; j < integrator.boundary_faces.size(); j++) {
+                    const auto &face = integrator.faces[integrator.boundary_faces[j].face];
+                    const size_t i = (face.loc == FaceLocation::LEFT) ? face.ip : face.im;
+                    boundary[level[i]].push_back(j);
+                }
+            }
+            team.sync();
+
+            for (size_t m = 0; m < M; m++) {
+                if (m > 0) synchronize(integrator, team, m, K);
+                for (size_t k = K + 1; k-- > 0;) {
+                    if (m % (size_t(1) << k) == 0) advance_level(integrator, team, k, m, dt_micro);
+                }
+            }
+            if (team.rank == 0) integrator.time += dt_micro * M;
+            synchronize(integrator, team, M, K);
+
+            return dt_micro * M;
+        }
+
+        scalar_t step(auto &integrator, scalar_t dt_max) {
+            scalar_t dt = 0.0;
+            integrator.run_team([&](const execution::Team &team) {
+                scalar_t dt_team = step(integrator, dt_max, team);
+                if (team.rank == 0) dt = dt_team;
+            });
+            return dt;
+        }
+    };
+
+    /**
+     * @brief implicit second-order backward differentiation formula (variable step)
+     *
+     * With w = dt / dt_prev, the new state solves
+     *
+     *      G(u) = u - g * ((1 + w) * u^n - w^2 / (1 + w) * u^n-1) - g * dt * L(u) = 0,
+     *      g = (1 + w) / (1 + 2w)
+     *
+     * by the Jacobian-free Newton-Krylov solver; the first step is backward Euler. L is the
+     * right hand side of the integrator, so the time step is only limited by accuracy: with
+     * the Driver it is the CFL step of the integrator, i.e. `cfl` can be set far above the
+     * explicit limit. Registers: u, u0 (u^n), u^n-1 and the Newton iterate of the solver, and
+     * the Krylov basis of `newton`.
+     *
+     * A step whose Newton iteration does not converge is rejected: `advance` restores u^n and
+     * the time and returns false. `step`, which the Driver calls, repeats a rejected step with
+     * half the size up to `max_rejections` times and returns the size of the accepted step, or
+     * 0 if none converged.
+     *
+     * In 1D the Jacobian I - g dt dL/du can also be assembled (`jacobian`): as a preconditioner
+     * of GMRES, or for Newton with direct block tridiagonal solves and no Krylov iterations.
+     * The assembled Jacobian freezes the dissipation of the flux solver, so the direct Newton
+     * iteration converges linearly but fast. `J.algorithm` selects the block Thomas solver or
+     * cyclic reduction over the threads of the team.
+     */
+    class BDF2 {
+    private:
+
+        aligned_vec<scalar_t> u_prev;   // u^n-1
+        aligned_vec<scalar_t> x;        // Newton iterate of u^n+1
+        scalar_t dt_prev = 0.0;         // 0: no previous step, backward Euler
+
+    public:
+        enum class Jacobian {
+            Free,           // Jacobian-free Newton-Krylov
+            Preconditioned, // GMRES preconditioned by the assembled Jacobian
+            Assembled       // Newton with the assembled Jacobian, one direct solve per iteration
+        };
+
+        static constexpr bool adaptive = true;
+
+        Jacobian jacobian = Jacobian::Free;
+        implicit::NewtonKrylov newton;
+        BlockTridiagonal<scalar_t> J;   // assembled I - g dt dL/du
+
+        size_t max_rejections = 8;      // halvings of a step before `step` gives up
+        size_t rejected = 0;
+
+        // start again with backward Euler, e.g. after changing u by hand
+        void reset() {
+            dt_prev = 0.0;
+        }
+
+        bool advance(auto &integrator, scalar_t dt, const execution::Team &team) {
+            const size_t n = integrator.field.u.size();
+            if (team.rank == 0 && x.size() != n) {
+                u_prev.resize(n);
+                x.resize(n);
+                reset();
+            }
+            team.sync();
+            integrator.reserve(team, Registers::RHS | Registers::U0);
+
+            scalar_t *u = integrator.field.u.data();
+            scalar_t *u0 = integrator.field.u0.data();
+            const scalar_t *dudt = integrator.field.dudt.data();
+            const scalar_t t = integrator.time;
+
+            const scalar_t w = (dt_prev > 0.0) ? dt / dt_prev : 0.0;
+            const scalar_t g = (1.0 + w) / (1.0 + 2.0 * w);
+            const scalar_t a0 = g * (1.0 + w);
+            const scalar_t a1 = -g * w * w / (1.0 + w);
+
+            // u^n is the initial guess
+            auto [begin, end] = team.chunk(n);
+            for (size_t i = begin; i < end; i++) {
+                u0[i] = u[i];
+                x[i] = u[i];
+            }
+            // L is evaluated at the end of the step, the residual synchronizes before
+            if (team.rank == 0) integrator.time += dt;
+
+            // field.u is the evaluation point of L
+            auto residual = [&](const execution::Team &team, const scalar_t *y, scalar_t *G) {
+                for (size_t i = begin; i < end; i++) u[i] = y[i];
+                team.sync();
+                integrator.compute_rhs(team);
+                team.sync();
+                for (size_t i = begin; i < end; i++) {
+                    G[i] = y[i] - a0 * u0[i] - a1 * u_prev[i] - g * dt * dudt[i];
+                }
+            };
+            bool converged;
+            if (jacobian == Jacobian::Free) {
+                converged = newton.solve(team, x.data(), n, residual, &integrator.comm);
+            } else {
+                implicit::Preconditioner precond{
+                    [&](const execution::Team &team, const scalar_t *y) {
+                        for (size_t i = begin; i < end; i++) u[i] = y[i];
+                        team.sync();
+                        integrator.assemble_jacobian(team, J, 1.0, -g * dt);
+                        J.factorize(team);
+                    },
+                    [&](const execution::Team &team, scalar_t *v) { J.solve(team, v); }
+                };
+                if (team.rank == 0) newton.krylov = (jacobian == Jacobian::Preconditioned);
+                team.sync();
+                converged = newton.solve(team, x.data(), n, residual, precond, &integrator.comm);
+            }
+            team.sync();
+
+            // reject: restore u^n, u^n-1 and dt_prev are kept
+            if (!converged) {
+                for (size_t i = begin; i < end; i++) u[i] = u0[i];
+                if (team.rank == 0) {
+                    integrator.time = t;
+                    rejected++;
+                }
+                team.sync();
+                return false;
+            }
+
+            for (size_t i = begin; i < end; i++) {
+                u_prev[i] = u0[i];
+                u[i] = x[i];
+            }
+            if (team.rank == 0) dt_prev = dt;
+            team.sync();
+            return true;
+        }
+
+        bool advance(auto &integrator, scalar_t dt) {
+            bool converged = false;
+            integrator.run_team([&](const execution::Team &team) {
+                bool converged_team = advance(integrator, dt, team);
+                if (team.rank == 0) converged = converged_team;
+            });
+            return converged;
+        }
+
+        scalar_t step(auto &integrator, scalar_t dt_max, const execution::Team &team) {
+            scalar_t dt = dt_max;
+            for (size_t k = 0; k <= max_rejections; k++, dt *= 0.5) {
+                if (advance(integrator, dt, team)) return dt;
+            }
+            return 0.0;
+        }
+
+        scalar_t step(auto &integrator, scalar_t dt_max) {
+            scalar_t dt = 0.0;
+            integrator.run_team([&](const execution::Team &team) {
+                scalar_t dt_team = step(integrator, dt_max, team);
+                if (team.rank == 0) dt = dt_team;
+            });
+            return dt;
+        }
     };
-}
\ No newline at end of file
+}
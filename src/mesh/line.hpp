@@ -2,66 +2,88 @@
 
 #include "core/types.hpp"
 #include "mesh.hpp"
+#include <cassert>
 #include <cstddef>
 
 namespace DG::mesh {
     /**
      *  @brief mesh with line cells (1D)
+     *
+     *  With `nranks > 1` the mesh is the partition of rank `rank`: a contiguous range of the
+     *  global cells. The faces at the ends of the range point to the neighbouring partitions
+     *  (`Face::rank`); the remote side of such a face has no local cell. Every rank gets at
+     *  least one cell, so there are at least as many cells as ranks.
      */
     struct Line : public Mesh<1> {
 
-        Line(size_t Ncells, scalar_t L) {
+        Line(size_t Ncells_global, scalar_t L, size_t rank = 0, size_t nranks = 1) {
+            assert(rank < nranks && "Invalid rank.");
+            assert(Ncells_global >= nranks && "Every partition needs at least one cell.");
 
-            this->Ncells = Ncells;
+            size_t first = Ncells_global * rank / nranks;
+            size_t last  = Ncells_global * (rank + 1) / nranks;
+
+            this->Ncells_global = Ncells_global;
+            this->cell_offset = first;
+            this->Ncells = last - first;
             this->Nfaces = Ncells + 1;
             this->cells.resize(Ncells);
             this->faces.resize(Nfaces);
 
-            scalar_t dx = L / Ncells;
+            scalar_t dx = L / Ncells_global;
 
             // initialize cell vertices
-            for (size_t i = 0; i < Ncells; i++) {
-                this->cells[i].index = i;
-                this->cells[i].vertices.resize(2);
-                this->cells[i].vertices[0].x = {i * dx};
-                this->cells[i].vertices[1].x = {(i + 1) * dx};
+            for (size_t k = 0; k < Ncells; k++) {
+                size_t i = first + k;   // global index
+                this->cells[k].index = i;
+                this->cells[k].vertices.resize(2);
+                this->cells[k].vertices[0].x = {i * dx};
+                this->cells[k].vertices[1].x = {(i + 1) * dx};
 
-                this->cells[i].map = [i=i, dx=dx](arr_t<1> x_ref) {
+                this->cells[k].map = [i=i, dx=dx](arr_t<1> x_ref) {
                     return arr_t<1>{0.5 * ((2*i + 1) * dx + x_ref[0] * dx)};
                 };
-                this->cells[i].size = {dx};
-                this->cells[i].detJ = 0.5 * dx;
+                this->cells[k].size = {dx};
+                this->cells[k].detJ = 0.5 * dx;
             }
 
             // initialize cell interfaces
-            for (size_t i = 0; i <= Ncells; i++) {
-                this->faces[i].center = {i * dx};
-                this->faces[i].area = 1.0;
-                faces[i].n = {1.0};
-                faces[i].loc = FaceLocation::INTER;
-                if (i == 0) {
-                    faces[i].ip = 0;
-                    faces[i].im = Ncells - 1;
-                } else if (i == Ncells) {
-                    faces[i].ip = 0;
-                    faces[i].im = Ncells - 1;
+            for (size_t k = 0; k <= Ncells; k++) {
+                this->faces[k].center = {(first + k) * dx};
+                this->faces[k].area = 1.0;
+                faces[k].n = {1.0};
+                faces[k].loc = FaceLocation::INTER;
+                if (nranks > 1 && (k == 0 || k == Ncells)) {
+                    // partition face, periodic across the first and last rank
+                    faces[k].ip = (k == 0) ? 0 : NoCell;
+                    faces[k].im = (k == 0) ? NoCell : Ncells - 1;
+                    faces[k].rank = (k == 0) ? (rank + nranks - 1) % nranks : (rank + 1) % nranks;
+                } else if (k == 0 || k == Ncells) {
+                    faces[k].ip = 0;
+                    faces[k].im = Ncells - 1;
                 } else {
-                    faces[i].ip = i;
-                    faces[i].im = i - 1;
+                    faces[k].ip = k;
+                    faces[k].im = k - 1;
                 }
             }
         }
 
         size_t set_boundary() {
-            this->faces[0].loc = FaceLocation::LEFT;
-            this->faces[0].im  = 0;
+            if (this->cell_offset == 0) {
+                this->faces[0].loc = FaceLocation::LEFT;
+                this->faces[0].im  = 0;
+                this->faces[0].rank = -1;
+            }
 
-            this->faces[this->Ncells].loc = FaceLocation::RIGHT;
-            this->faces[this->Ncells].ip  = this->Ncells - 1;
+            if (this->cell_offset + this->Ncells == this->Ncells_global) {
+                this->faces[this->Ncells].loc = FaceLocation::RIGHT;
+                this->faces[this->Ncells].ip  = this->Ncells - 1;
+                this->faces[this->Ncells].rank = -1;
+            }
 
             return 2;   // number of boundaries
         }
 
         ~Line() = default;
     };
-}
\ No newline at end of file
+}
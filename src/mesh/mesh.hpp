@@ -2,11 +2,15 @@
 
 #include <cstddef>
 #include <functional>
+#include <limits>
 #include <DG.hpp>
 #include "core/types.hpp"
 
 namespace DG::mesh {
 
+    /* cell index of the remote side of a partition face */
+    inline constexpr size_t NoCell = std::numeric_limits<size_t>::max();
+
     /**
      *  @brief nodes of a cell
      */
@@ -47,6 +51,7 @@ namespace DG::mesh {
         scalar_t area;
 
         size_t loc;     // location of the face
+        int rank = -1;  // partition faces: rank owning the cell on the other side
     };
 
     /**
@@ -56,6 +61,8 @@ namespace DG::mesh {
     struct Mesh {
         size_t Ncells;      // number of cells 
         size_t Nfaces;      // number of faces
+        size_t Ncells_global = 0;   // number of cells of all partitions
+        size_t cell_offset = 0;     // global index of the first cell
         std::vector<Face<ND>> faces; 
         std::vector<Cell<ND>> cells;
 
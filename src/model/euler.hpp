@@ -1,7 +1,9 @@
 #pragma once
 
 #include <DG.hpp>
+#include <array>
 #include <cstddef>
+#include "core/simd.hpp"
 #include "core/types.hpp"
 #include "model.hpp"
 
@@ -20,14 +22,17 @@ namespace DG::model {
         static constexpr size_t ip = ND + 1;   // pressure index
         static constexpr scalar_t gamma = 1.4;
 
-        // for convenience
-        // using var_t = arr_t<NumEqns>;
+        // state vector, fixed size and allocated on the stack
+        using var_t = arr_t<NumEqns>;
+
+        // Jacobian of a flux with respect to the conservative variables
+        using jac_t = matrix<scalar_t, NumEqns, NumEqns>;
 
         /*
             compute flux in one dimension using conservative variables
         */
-        static vec_t Fu(const vec_t &u, const size_t dim) {
-            vec_t F(u.size());
+        static var_t Fu(const var_t &u, const size_t dim) {
+            var_t F;
             size_t in = 1 + dim;	        // normal velocity index
 
 			for (size_t i = 0; i < ND; ++i) {
@@ -41,11 +46,112 @@ namespace DG::model {
 			return F;
         }
 
+        /*
+            Jacobian dF/du of the flux in one dimension, A(i, j) = dF_i / du_j
+        */
+        static jac_t dFdu(const var_t &u, const size_t dim) {
+            jac_t A;
+            A = 0.0;
+            size_t in = 1 + dim;	        // normal velocity index
+
+            scalar_t ke = 0.0;
+            for (size_t i = 0; i < ND; ++i) {
+                ke += 0.5 * u[1 + i] * u[1 + i] / (u[0] * u[0]);
+            }
+            const scalar_t p  = pressure(u);
+            const scalar_t un = u[in] / u[0];
+            const scalar_t H  = (u[ip] + p) / u[0];     // total enthalpy
+
+            // dp/du
+            var_t dp;
+            dp[0]  = (gamma - 1) * ke;
+            for (size_t j = 0; j < ND; ++j) {
+                dp[1 + j] = -(gamma - 1) * u[1 + j] / u[0];
+            }
+            dp[ip] = gamma - 1;
+
+            A(0, in) = 1.0;
+
+            for (size_t i = 0; i < ND; ++i) {
+                const scalar_t vi = u[1 + i] / u[0];
+                A(1 + i, 0)   = -un * vi;
+                A(1 + i, in) += vi;
+                A(1 + i, 1 + i) += un;
+            }
+            for (size_t j = 0; j < NumEqns; ++j) {
+                A(in, j) += dp[j];
+            }
+
+            A(ip, 0)  = -un * H + un * dp[0];
+            for (size_t j = 0; j < ND; ++j) {
+                A(ip, 1 + j) = un * dp[1 + j];
+            }
+            A(ip, in) += H;
+            A(ip, ip)  = gamma * un;
+
+            return A;
+        }
+
+        /*
+            compute flux in one dimension for a batch of n nodes in SoA layout:
+            u[k * ld + i] is equation k of node i, same for F
+        */
+        static void Fu_batch(const scalar_t *u, scalar_t *F, const size_t n, const size_t ld, const size_t dim) {
+            using pack_t = simd::pack<scalar_t>;
+            constexpr size_t W = simd::width<scalar_t>;
+
+            size_t i = 0;
+            for (; i + W <= n; i += W) {
+                std::array<pack_t, NumEqns> ub, Fb;
+                for (size_t k = 0; k < NumEqns; k++) {
+                    ub[k] = simd::load(u + k * ld + i);
+                }
+                flux_kernel(ub, Fb, dim);
+                for (size_t k = 0; k < NumEqns; k++) {
+                    simd::store(Fb[k], F + k * ld + i);
+                }
+            }
+
+            // remainder
+            for (; i < n; i++) {
+                std::array<scalar_t, NumEqns> ub, Fb;
+                for (size_t k = 0; k < NumEqns; k++) {
+                    ub[k] = u[k * ld + i];
+                }
+                flux_kernel(ub, Fb, dim);
+                for (size_t k = 0; k < NumEqns; k++) {
+                    F[k * ld + i] = Fb[k];
+                }
+            }
+        }
+
+        /*
+            flux kernel shared by the scalar and the SIMD path, V is scalar_t or a simd::pack
+        */
+        template<typename V>
+        static void flux_kernel(const std::array<V, NumEqns> &u, std::array<V, NumEqns> &F, const size_t dim) {
+            size_t in = 1 + dim;	        // normal velocity index
+
+            V ke = 0.0;
+            for (size_t i = 0; i < ND; ++i) {
+                ke += 0.5 * u[1 + i] * u[1 + i];
+            }
+            V p = (gamma - 1) * (u[ip] - ke / u[0]);
+
+            for (size_t i = 0; i < ND; ++i) {
+                F[1 + i] = u[in] * u[1 + i] / u[0];
+            }
+
+            F[0]   = u[in];
+            F[in] += p;
+            F[ip]  = u[in] / u[0] * (u[ip] + p);
+        }
+
         /*
             compute flux in one dimension using primitive variables
         */
-        static vec_t Fp(const vec_t &p, const size_t dim) {
-            vec_t F(p.size());
+        static var_t Fp(const var_t &p, const size_t dim) {
+            var_t F;
             size_t in = 1 + dim;	// normal velocity index
 			scalar_t ke = 0.0;		// specific kinetic energy
 
@@ -64,8 +170,8 @@ namespace DG::model {
         /*
             conserved to primitive variables
         */
-        static vec_t UtoP (const vec_t &u) {
-            vec_t p(u.size());
+        static var_t UtoP (const var_t &u) {
+            var_t p;
 
             p[0] = u[0];
 			for (size_t i = 0; i < ND; ++i) {
@@ -79,8 +185,8 @@ namespace DG::model {
         /*
             primitive to conserved variables
         */
-        static vec_t PtoU (const vec_t &p) {
-            vec_t u(p.size());
+        static var_t PtoU (const var_t &p) {
+            var_t u;
             scalar_t ke = 0;
 
 			u[0] = p[0];
@@ -110,7 +216,7 @@ namespace DG::model {
         /*
             pressure
         */
-        static scalar_t pressure(const vec_t &u) {
+        static scalar_t pressure(const var_t &u) {
 			scalar_t ke = 0;
 			for (size_t i = 0; i < ND; ++i) {
 				ke += 0.5 * u[1 + i] * u[1 + i];
@@ -121,7 +227,7 @@ namespace DG::model {
         /*
             speed of sound
         */
-        inline static scalar_t sound_speed(const vec_t &u) {
+        inline static scalar_t sound_speed(const var_t &u) {
 			return std::sqrt(gamma * pressure(u) / u[0]);
 		}
 
@@ -132,11 +238,11 @@ namespace DG::model {
         /*
             compute wave speed
         */
-        inline static scalar_t max_wave_speed(const vec_t &p, const size_t dim) {
+        inline static scalar_t max_wave_speed(const var_t &p, const size_t dim) {
             return p[1 + dim] + sound_speed(p);
         }
 
-        inline static scalar_t min_wave_speed(const vec_t &p, const size_t dim) {
+        inline static scalar_t min_wave_speed(const var_t &p, const size_t dim) {
             return p[1 + dim] - sound_speed(p);
         }
 
@@ -1,54 +1,237 @@
 #pragma once
 
 #include <DG.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace DG::scene {
 
+	/*
+		Boundary condition policies. Each policy maps the trace of the interior cell at a
+		boundary face with center x and unit normal n at time t to the state outside of the
+		face, `operator()(u, x, n, t)`, and provides its derivative with respect to u,
+		`jacobian`. The boundary flux is the numerical flux between the outside state and the
+		trace. All states are conservative variables.
+	*/
+	namespace bc {
+
+		/* fixed state */
+		template<typename Model>
+		struct Dirichlet {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+
+			var_t value;
+
+			var_t operator()(const var_t &, const dim_t &, const dim_t &, scalar_t) const {
+				return value;
+			}
+
+			jac_t jacobian(const var_t &, const dim_t &) const {
+				jac_t J;
+				J = 0.0;
+				return J;
+			}
+		};
+
+		/*
+			state prescribed by a function of the face center and the time, e.g. an analytic
+			solution; the function is called once per face and evaluation
+		*/
+		template<typename Model>
+		struct Function {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+
+			std::function<var_t(const dim_t &, scalar_t)> value;
+
+			var_t operator()(const var_t &, const dim_t &x, const dim_t &, scalar_t t) const {
+				return value(x, t);
+			}
+
+			jac_t jacobian(const var_t &, const dim_t &) const {
+				jac_t J;
+				J = 0.0;
+				return J;
+			}
+		};
+
+		/* zero gradient, the interior trace */
+		template<typename Model>
+		struct Neumann {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+
+			var_t operator()(const var_t &u, const dim_t &, const dim_t &, scalar_t) const {
+				return u;
+			}
+
+			jac_t jacobian(const var_t &, const dim_t &) const {
+				jac_t J;
+				J = 0.0;
+				for (size_t k = 0; k < Model::NumEqns; k++) J(k, k) = 1.0;
+				return J;
+			}
+		};
+
+		/* reflective (slip) wall: the interior trace with its normal momentum reversed */
+		template<typename Model>
+		struct Wall {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+			static constexpr size_t ND = Model::NumDims;
+
+			var_t operator()(const var_t &u, const dim_t &, const dim_t &n, scalar_t) const {
+				scalar_t mn = 0.0;		// normal momentum
+				for (size_t i = 0; i < ND; ++i) mn += u[1 + i] * n[i];
+
+				var_t ub = u;
+				for (size_t i = 0; i < ND; ++i) ub[1 + i] -= 2.0 * mn * n[i];
+				return ub;
+			}
+
+			jac_t jacobian(const var_t &, const dim_t &n) const {
+				jac_t J;
+				J = 0.0;
+				for (size_t k = 0; k < Model::NumEqns; k++) J(k, k) = 1.0;
+				for (size_t i = 0; i < ND; ++i) {
+					for (size_t j = 0; j < ND; ++j) J(1 + i, 1 + j) -= 2.0 * n[i] * n[j];
+				}
+				return J;
+			}
+		};
+
+		/*
+			periodic pair of boundaries: resolved by the integrator into interior faces between
+			the cells at the two ends, so it is never evaluated
+		*/
+		template<typename Model>
+		struct Periodic {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+
+			var_t operator()(const var_t &u, const dim_t &, const dim_t &, scalar_t) const {
+				assert(false && "Periodic boundaries are interior faces.");
+				return u;
+			}
+
+			jac_t jacobian(const var_t &u, const dim_t &n) const {
+				return Neumann<Model>{}.jacobian(u, n);
+			}
+		};
+
+		/*
+			time-dependent inflow from a sampled table: the state is interpolated linearly
+			between the samples (times[k], values[k]) and constant outside of the table
+		*/
+		template<typename Model>
+		struct Inflow {
+			using var_t = typename Model::var_t;
+			using jac_t = typename Model::jac_t;
+			using dim_t = arr_t<Model::NumDims>;
+
+			std::vector<scalar_t> times;	// increasing
+			std::vector<var_t> values;
+
+			var_t operator()(const var_t &, const dim_t &, const dim_t &, scalar_t t) const {
+				if (t <= times.front()) return values.front();
+				if (t >= times.back()) return values.back();
+
+				const size_t k = std::upper_bound(times.begin(), times.end(), t) - times.begin();
+				const scalar_t theta = (t - times[k - 1]) / (times[k] - times[k - 1]);
+				var_t value;
+				for (size_t e = 0; e < Model::NumEqns; e++) {
+					value[e] = values[k - 1][e] + theta * (values[k][e] - values[k - 1][e]);
+				}
+				return value;
+			}
+
+			jac_t jacobian(const var_t &, const dim_t &) const {
+				jac_t J;
+				J = 0.0;
+				return J;
+			}
+		};
+	}
+
 	/**
-	 *	@brief Define the type of a boundary face
+	 *	@brief boundary condition of a boundary, one of the policies of `bc`
+	 *
+	 *	The policy is a variant, `visit` dispatches once and runs a function with the concrete
+	 *	policy type, so a loop over the faces of a boundary inside the visitor is compiled for
+	 *	each policy without an indirect call per face.
 	 */
 	template<typename Model>
 	struct Boundary {
-		// using var_t = typename Model::var_t;
-		// using dim_t = arr_t<Model::NumDims>;
-		
-		enum class Type {
-			Dirichlet,
-			Neumann
-		} type;
-
-		vec_t value;	// TODO: can be optional
-		
+		using var_t = typename Model::var_t;
+		using jac_t = typename Model::jac_t;
+		using dim_t = arr_t<Model::NumDims>;
+
+		using policy_t = std::variant<bc::Dirichlet<Model>, bc::Function<Model>, bc::Neumann<Model>, bc::Wall<Model>, bc::Periodic<Model>, bc::Inflow<Model>>;
+
+		policy_t policy;
+
 		/*
-			Constructors used by the scene to set up boundary conditions
-			return values are saved into scene::face_info
+			Constructors used by the scene to set up boundary conditions, they are evaluated
+			once by the integrator
 		*/
-		static Boundary Dirichlet(vec_t value) {
-			return {Type::Dirichlet, value};
+		static Boundary Dirichlet(var_t value) {
+			return {bc::Dirichlet<Model>{value}};
+		}
+
+		// state of value(x, t) at the face center x and time t
+		template<typename F> requires std::is_invocable_r_v<var_t, F, const dim_t &, scalar_t>
+		static Boundary Dirichlet(F value) {
+			return {bc::Function<Model>{std::move(value)}};
 		}
 
 		static Boundary Neumann() {
-			vec_t value(Model::NumEqns);
-			return {Type::Neumann, value};
+			return {bc::Neumann<Model>{}};
 		}
 
-		/*
-			return boundary values
-			Only for fixed inlet conditions, member value remain unchanged; otherwise, value is updated based on boundary cell
-		*/
-		vec_t boundary_value(const vec_t &cell_value) {
+		static Boundary Wall() {
+			return {bc::Wall<Model>{}};
+		}
 
-			if (type == Type::Dirichlet) {
+		static Boundary Periodic() {
+			return {bc::Periodic<Model>{}};
+		}
 
-				return value;
+		static Boundary Inflow(std::vector<scalar_t> times, std::vector<var_t> values) {
+			assert(!times.empty() && times.size() == values.size() && "Invalid inflow table.");
+			return {bc::Inflow<Model>{std::move(times), std::move(values)}};
+		}
 
-			} else if (type == Type::Neumann) {
+		template<typename P>
+		bool is() const {
+			return std::holds_alternative<P>(policy);
+		}
 
-				return cell_value;
-			}
+		template<typename F>
+		decltype(auto) visit(F &&f) const {
+			return std::visit(std::forward<F>(f), policy);
+		}
+
+		/*
+			boundary value and its derivative with respect to the cell value, with one dispatch
+			per call
+		*/
+		var_t boundary_value(const var_t &cell_value, const dim_t &x, const dim_t &n, scalar_t t) const {
+			return visit([&](const auto &p) { return p(cell_value, x, n, t); });
+		}
 
-			assert(false && "Invalid boundary condition.");
-			return value;
+		jac_t boundary_jacobian(const var_t &cell_value, const dim_t &n) const {
+			return visit([&](const auto &p) { return p.jacobian(cell_value, n); });
 		}
 	};
-}
\ No newline at end of file
+}
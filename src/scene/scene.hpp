@@ -18,11 +18,11 @@ namespace DG::scene {
             Initial condition function pointer
             (x) -> (var_t)
         */
-        using ic_t = std::function<vec_t(const arr_t<Model::NumDims>&)>;
+        using ic_t = std::function<typename Model::var_t(const arr_t<Model::NumDims>&)>;
 
         /*
-            Boundary condition function pointer
-            TODO: could add input arguments to the function, e.g. (x, t) -> (Boundary<Model>)
+            Boundary condition function pointer, evaluated once by the integrator; the
+            returned policy may depend on (x, t), e.g. Boundary<Model>::Inflow
         */
         using bc_t = std::function<Boundary<Model>()>;
 
@@ -1,5 +1,7 @@
 #include <DG.hpp>
 #include "core/basis.hpp"
+#include "core/blockTridiagonal.hpp"
+#include "integrator/cell.hpp"
 
 using namespace DG;
 
@@ -71,6 +73,189 @@ bool test_matrix() {
     return 0;
 }
 
+bool test_expression() {
+    /*
+        fused expressions must match the element-wise result
+    */
+    mat_t u0 = {{1.0, 2.0}, {3.0, 4.0}};
+    mat_t u  = {{0.5, 1.5}, {2.5, 3.5}};
+    mat_t du = {{1.0, -1.0}, {2.0, -2.0}};
+    scalar_t dt = 0.1;
+
+    mat_t ref = u;
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            ref(i, j) = (u0(i, j) + u(i, j) * 2.0 + du(i, j) * dt * 2.0) / 3.0;
+        }
+    }
+
+    // the target also appears on the right hand side
+    u = (u0 + u * 2.0 + du * dt * 2.0) / 3.0;
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            if (u(i, j) != ref(i, j)) return 1;
+        }
+    }
+    if (u.rows() != 2 || u.cols() != 2) return 1;
+
+    // compound operators and mixed matrix products
+    u += du * 0.5;
+    mat_t P = u0 * (u - du);
+    if (P.rows() != 2 || P.cols() != 2) return 1;
+
+    vec_t a = {1.0, 2.0, 3.0};
+    vec_t b = -a + a * 2.0;
+    if (b[0] != 1.0 || b[1] != 2.0 || b[2] != 3.0) return 1;
+
+    return 0;
+}
+
+bool test_quadrature() {
+    /*
+        Newton and Golub-Welsch nodes must agree, weights integrate constants exactly
+    */
+    for (size_t n : {2, 3, 5, 9, 17, 33}) {
+        Lobatto  L1(n, NodeSolver::Newton), L2(n, NodeSolver::GolubWelsch);
+        Gaussian G1(n, NodeSolver::Newton), G2(n, NodeSolver::GolubWelsch);
+
+        scalar_t sum_L = 0.0, sum_G = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            if (std::abs(L1.x[i] - L2.x[i]) > 1e-14) return 1;
+            if (std::abs(G1.x[i] - G2.x[i]) > 1e-14) return 1;
+            sum_L += L2.w[i];
+            sum_G += G2.w[i];
+        }
+        if (std::abs(sum_L - 2.0) > 1e-13 || std::abs(sum_G - 2.0) > 1e-13) return 1;
+    }
+
+    return 0;
+}
+
+/*
+    compile-time operators must match the run-time reference cell, and the default reference
+    cell must load them
+*/
+template<size_t N>
+bool test_table() {
+    constexpr const RefTable<N> &T = ref_table<N>;
+    static_assert(T.x[0] == -1.0 && T.x[N-1] == 1.0);
+
+    RefCell c(N, NodeSolver::Newton);
+    for (size_t i = 0; i < N; i++) {
+        if (std::abs(T.x[i] - c.x[i]) > 1e-14) return 1;
+        if (std::abs(T.w[i] - c.w[i]) > 1e-14) return 1;
+        if (std::abs(T.lift_L[i] - c.lift_L[i]) > 1e-12) return 1;
+        if (std::abs(T.lift_R[i] - c.lift_R[i]) > 1e-12) return 1;
+        for (size_t j = 0; j < N; j++) {
+            if (std::abs(T.D[i * N + j] - c.D(i, j)) > 1e-12 * N) return 1;
+            if (std::abs(T.Minv[i * N + j] - c.Minv(i, j)) > 1e-12 * N) return 1;
+        }
+    }
+
+    RefCell loaded(N);
+    for (size_t i = 0; i < N; i++) {
+        if (loaded.x[i] != T.x[i] || loaded.lift_L[i] != T.lift_L[i]) return 1;
+        for (size_t j = 0; j < N; j++) {
+            if (loaded.D(i, j) != T.D[i * N + j]) return 1;
+        }
+    }
+
+    return 0;
+}
+
+bool test_tables() {
+    // the largest fixed-size cell and the largest table
+    return test_table<integrator::MaxFixedNodes>() || test_table<MaxTableNodes>();
+}
+
+bool test_factorization() {
+    /*
+        blocked LU (block smaller than n) and Cholesky solves must reproduce the right hand side
+    */
+    const size_t n = 40;
+    RefCell c(n, NodeSolver::GolubWelsch);
+
+    mat_t A = c.V;
+    mat_t X(n, 3);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            X(i, j) = std::sin(1.0 + i + 7.0 * j);
+        }
+    }
+
+    LU<scalar_t> lu(A, 8);
+    mat_t Y = lu.solve(A * X);
+    vec_t y = lu.solve(A * X.transpose()[0]);
+    for (size_t i = 0; i < n; i++) {
+        if (std::abs(y[i] - X(i, 0)) > 1e-10) return 1;
+        for (size_t j = 0; j < 3; j++) {
+            if (std::abs(Y(i, j) - X(i, j)) > 1e-10) return 1;
+        }
+    }
+
+    // the mass matrix is symmetric positive definite
+    mat_t MMinv = c.M * c.Minv;
+    mat_t Z = c.Minv.cholesky().solve(c.Minv * X);
+    for (size_t i = 0; i < n; i++) {
+        if (std::abs(MMinv(i, i) - 1.0) > 1e-10) return 1;
+        for (size_t j = 0; j < 3; j++) {
+            if (std::abs(Z(i, j) - X(i, j)) > 1e-10) return 1;
+        }
+    }
+
+    return 0;
+}
+
+bool test_block_tridiagonal() {
+    /*
+        block Thomas and cyclic reduction, with and without corner blocks, must reproduce x
+        from A x
+    */
+    using algorithm_t = BlockTridiagonal<scalar_t>::Algorithm;
+    const size_t N = 13;
+    const size_t b = 3;
+
+    for (bool periodic : {false, true}) {
+        for (algorithm_t algorithm : {algorithm_t::Thomas, algorithm_t::CyclicReduction}) {
+            BlockTridiagonal<scalar_t> A(N, b, periodic);
+            A.algorithm = algorithm;
+            for (size_t i = 0; i < N; i++) {
+                for (size_t r = 0; r < b; r++) {
+                    for (size_t c = 0; c < b; c++) {
+                        A.lower[i](r, c) = std::sin(1.0 + i + 3.0 * r + 7.0 * c);
+                        A.upper[i](r, c) = std::cos(2.0 + i + 5.0 * r + c);
+                        A.diag[i](r, c)  = std::sin(3.0 * i + r + 2.0 * c) + (r == c ? 4.0 : 0.0);
+                    }
+                }
+            }
+
+            vec_t x(N * b), y(N * b);
+            for (size_t i = 0; i < N * b; i++) x[i] = std::sin(0.5 * i);
+            for (size_t i = 0; i < N; i++) {
+                const size_t il = (i + N - 1) % N;
+                const size_t ir = (i + 1) % N;
+                for (size_t r = 0; r < b; r++) {
+                    scalar_t sum = 0.0;
+                    for (size_t c = 0; c < b; c++) {
+                        sum += A.diag[i](r, c) * x[i * b + c];
+                        if (i > 0 || periodic)     sum += A.lower[i](r, c) * x[il * b + c];
+                        if (i < N - 1 || periodic) sum += A.upper[i](r, c) * x[ir * b + c];
+                    }
+                    y[i * b + r] = sum;
+                }
+            }
+
+            A.factorize();
+            A.solve(&y[0]);
+            for (size_t i = 0; i < N * b; i++) {
+                if (std::abs(y[i] - x[i]) > 1e-10) return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
 bool test_basis() {
     RefCell c(5);
     std::cout << c.x << std::endl;
@@ -93,6 +278,31 @@ int main() {
     //     return 1;
     // }
 
+    if (test_expression()) {
+        std::cout << "Expression test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_quadrature()) {
+        std::cout << "Quadrature test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_tables()) {
+        std::cout << "Table test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_factorization()) {
+        std::cout << "Factorization test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_block_tridiagonal()) {
+        std::cout << "Block tridiagonal test failed!" << std::endl;
+        return 1;
+    }
+
     if (test_basis()) {
         std::cout << "Basis test failed!" << std::endl;
         return 1;
@@ -0,0 +1,139 @@
+#include <DG.hpp>
+#include <algorithm>
+#include <cmath>
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/timeSolver.hpp"
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using fSolver = integrator::flux::LaxFriedrichs<model_t>;
+using integrator_t = integrator::Integrator<model_t, fSolver>;
+
+using Boundary = scene::Boundary<model_t>;
+using var_t = model_t::var_t;
+
+bool equal(const var_t &a, const var_t &b, scalar_t tol = 0.0) {
+    for (size_t k = 0; k < model_t::NumEqns; k++) {
+        if (std::abs(a[k] - b[k]) > tol) return false;
+    }
+    return true;
+}
+
+/*
+    outside states of the policies against hand-computed ones, for the trace u of a cell at
+    both ends of the domain
+*/
+bool test_policies() {
+    const var_t u = {1.5, -0.6, 2.5};
+    const arr_t<1> x_L = {0.0}, x_R = {1.0};
+    const arr_t<1> n_L = {-1.0}, n_R = {1.0};
+
+    // fixed state, independent of the trace, the face and the time
+    const var_t ub = {1.0, 0.2, 3.0};
+    const Boundary dirichlet = Boundary::Dirichlet(ub);
+    if (!equal(dirichlet.boundary_value(u, x_L, n_L, 0.0), ub) || !equal(dirichlet.boundary_value(u, x_R, n_R, 7.0), ub)) return 1;
+
+    // zero gradient: the trace itself
+    const Boundary neumann = Boundary::Neumann();
+    if (!equal(neumann.boundary_value(u, x_L, n_L, 0.0), u) || !equal(neumann.boundary_value(u, x_R, n_R, 1.0), u)) return 1;
+
+    // slip wall: the normal momentum is reversed, density and energy are kept
+    const Boundary wall = Boundary::Wall();
+    const var_t mirrored = {1.5, 0.6, 2.5};
+    if (!equal(wall.boundary_value(u, x_L, n_L, 0.0), mirrored) || !equal(wall.boundary_value(u, x_R, n_R, 0.0), mirrored)) return 1;
+
+    // inflow table: constant before the first and after the last time, linear in between
+    const var_t a = {1.0, 0.0, 2.0}, b = {2.0, 1.0, 4.0}, c = {2.0, 3.0, 4.0};
+    const Boundary inflow = Boundary::Inflow({1.0, 2.0, 4.0}, {a, b, c});
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 0.0), a)) return 1;
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 1.0), a)) return 1;
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 1.25), var_t{1.25, 0.25, 2.5}, 1e-15)) return 1;
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 2.0), b, 1e-15)) return 1;
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 3.5), var_t{2.0, 2.5, 4.0}, 1e-15)) return 1;
+    if (!equal(inflow.boundary_value(u, x_L, n_L, 4.0), c) || !equal(inflow.boundary_value(u, x_L, n_L, 10.0), c)) return 1;
+
+    // function of the face center and the time
+    const Boundary function = Boundary::Dirichlet([] (const arr_t<1>& x, scalar_t t) {
+        return var_t{1.0 + x[0], t, 2.0};
+    });
+    if (!equal(function.boundary_value(u, x_L, n_L, 0.5), var_t{1.0, 0.5, 2.0})) return 1;
+    if (!equal(function.boundary_value(u, x_R, n_R, 3.0), var_t{2.0, 3.0, 2.0})) return 1;
+
+    // derivatives of the outside state: 0 for prescribed states, I for Neumann, the
+    // reflection of the normal momentum for the wall
+    for (size_t i = 0; i < model_t::NumEqns; i++) {
+        for (size_t j = 0; j < model_t::NumEqns; j++) {
+            const scalar_t identity = (i == j) ? 1.0 : 0.0;
+            if (dirichlet.boundary_jacobian(u, n_L)(i, j) != 0.0) return 1;
+            if (inflow.boundary_jacobian(u, n_L)(i, j) != 0.0) return 1;
+            if (function.boundary_jacobian(u, n_L)(i, j) != 0.0) return 1;
+            if (neumann.boundary_jacobian(u, n_L)(i, j) != identity) return 1;
+            if (wall.boundary_jacobian(u, n_R)(i, j) != ((i == 1) ? -identity : identity)) return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    a density wave leaving and entering the domain: with the exact solution as the state of
+    both boundaries, Dirichlet(f) of x and t keeps the solution on the exact one
+*/
+bool test_function() {
+    auto exact = [] (const arr_t<1>& x, scalar_t t) {
+        return model_t::PtoU({2.0 + std::sin(2.0 * M_PI * (x[0] - t)), 1.0, 1.0});
+    };
+
+    mesh::Line mesh(20, 1.0);
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        return model_t::var_t{2.0 + std::sin(2.0 * M_PI * x[0]), 1.0, 1.0};
+    };
+    scene.boundary_conditions.resize(mesh.set_boundary());
+    scene.boundary_conditions[LEFT] = [&] () {
+        return scene::Boundary<model_t>::Dirichlet(exact);
+    };
+    scene.boundary_conditions[RIGHT] = [&] () {
+        return scene::Boundary<model_t>::Dirichlet(exact);
+    };
+
+    integrator_t integrator{mesh, scene, 3, 0.25};
+    integrator::time::SSP_RK3 solver;
+    const scalar_t end_time = 0.3;
+    while (integrator.time < end_time) {
+        solver.advance(integrator, std::min(integrator.compute_dt_global(), end_time - integrator.time));
+    }
+
+    constexpr size_t NE = model_t::NumEqns;
+    scalar_t error = 0.0;
+    for (size_t i = 0; i < integrator.field.x.size(); i++) {
+        const model_t::var_t u = exact(integrator.field.x[i], integrator.time);
+        for (size_t k = 0; k < NE; k++) {
+            error = std::max(error, std::abs(integrator.field.u[i * NE + k] - u[k]));
+        }
+    }
+    if (!(error < 1e-4)) return 1;
+
+    return 0;
+}
+
+int main() {
+    if (test_policies()) {
+        std::cout << "Boundary policy test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_function()) {
+        std::cout << "Boundary function test failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include <DG.hpp>
+#include "core/comm.hpp"
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/timeSolver.hpp"
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using fSolver = integrator::flux::LaxFriedrichs<model_t>;
+
+/*
+    the partitioned shock tube must reproduce the serial one bit for bit, on every rank; the
+    partition faces use the scalar numerical flux, the others the batched one
+*/
+template<typename tSolver_t, typename fSolver_t = fSolver>
+bool test_partition(bool periodic, const mpi::Communicator &comm) {
+    size_t porder = 4;
+    size_t mesh_size = 50;
+    scalar_t cfl = 0.5;
+
+    mesh::Line serial_mesh(mesh_size, 1.0);
+    mesh::Line local_mesh(mesh_size, 1.0, comm.rank(), comm.size());
+
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        if (x[0] < 0.5) 
+            return model_t::var_t{2.0, 0.0, 2.0e5};
+        else
+            return model_t::var_t{1.0, 0.0, 1.0e5};
+    };
+    if (!periodic) {
+        scene.boundary_conditions.resize(serial_mesh.set_boundary());
+        local_mesh.set_boundary();
+        scene.boundary_conditions[LEFT] = [] () {
+            return scene::Boundary<model_t>::Neumann();
+        };
+        scene.boundary_conditions[RIGHT] = [] () {
+            return scene::Boundary<model_t>::Neumann();
+        };
+    }
+
+    using policy_t = execution::parallel_policy;
+    integrator::Integrator<model_t, fSolver_t, 5> serial{serial_mesh, scene, porder, cfl};
+    integrator::Integrator<model_t, fSolver_t, 5, policy_t> local{local_mesh, scene, porder, cfl, policy_t{2}};
+    tSolver_t serial_solver, local_solver;
+
+    for (size_t step = 0; step < 50; step++) {
+        scalar_t dt = serial.compute_dt_global();
+        if (local.compute_dt_global() != dt) return 1;
+        if constexpr (integrator::time::is_adaptive<tSolver_t>) {
+            // the error norm and the controller must agree as well
+            if (serial_solver.step(serial, dt) != local_solver.step(local, dt)) return 1;
+        } else {
+            serial_solver.advance(serial, dt);
+            local_solver.advance(local, dt);
+        }
+    }
+
+    const size_t stride = local.field.stride();
+    const size_t offset = local_mesh.cell_offset * stride;
+    for (size_t i = 0; i < local_mesh.Ncells * stride; i++) {
+        if (local.field.u[i] != serial.field.u[offset + i]) return 1;
+    }
+
+    return 0;
+}
+
+/*
+    boundary policies on the partitioned mesh: a pair of periodic policies must reproduce the
+    periodic mesh, and a time-dependent inflow with a wall the serial run, bit for bit
+*/
+template<typename tSolver_t>
+bool test_boundary_policies(const mpi::Communicator &comm) {
+    size_t porder = 4;
+    size_t mesh_size = 50;
+    scalar_t cfl = 0.5;
+
+    mesh::Line periodic_mesh(mesh_size, 1.0);
+    mesh::Line serial_mesh(mesh_size, 1.0);
+    mesh::Line local_mesh(mesh_size, 1.0, comm.rank(), comm.size());
+    serial_mesh.set_boundary();
+    local_mesh.set_boundary();
+
+    scene::Scene<model_t> periodic_scene;
+    periodic_scene.initial_condition = [] (const arr_t<1>& x) {
+        if (x[0] < 0.5)
+            return model_t::var_t{2.0, 50.0, 2.0e5};
+        else
+            return model_t::var_t{1.0, 50.0, 1.0e5};
+    };
+    scene::Scene<model_t> scene = periodic_scene;
+    scene.boundary_conditions.resize(2);
+    scene.boundary_conditions[LEFT] = [] () {
+        return scene::Boundary<model_t>::Periodic();
+    };
+    scene.boundary_conditions[RIGHT] = [] () {
+        return scene::Boundary<model_t>::Periodic();
+    };
+
+    using policy_t = execution::parallel_policy;
+    {
+        integrator::Integrator<model_t, fSolver, 5> serial{periodic_mesh, periodic_scene, porder, cfl};
+        integrator::Integrator<model_t, fSolver, 5, policy_t> local{local_mesh, scene, porder, cfl, policy_t{2}};
+        tSolver_t serial_solver, local_solver;
+
+        for (size_t step = 0; step < 50; step++) {
+            scalar_t dt = serial.compute_dt_global();
+            serial_solver.advance(serial, dt);
+            local_solver.advance(local, dt);
+        }
+
+        const size_t stride = local.field.stride();
+        const size_t offset = local_mesh.cell_offset * stride;
+        for (size_t i = 0; i < local_mesh.Ncells * stride; i++) {
+            if (local.field.u[i] != serial.field.u[offset + i]) return 1;
+        }
+    }
+
+    scene.boundary_conditions[LEFT] = [] () {
+        return scene::Boundary<model_t>::Inflow({0.0, 1e-4}, {model_t::PtoU({2.0, 50.0, 2.0e5}), model_t::PtoU({2.0, 100.0, 2.1e5})});
+    };
+    scene.boundary_conditions[RIGHT] = [] () {
+        return scene::Boundary<model_t>::Wall();
+    };
+    {
+        integrator::Integrator<model_t, fSolver, 5> serial{serial_mesh, scene, porder, cfl};
+        integrator::Integrator<model_t, fSolver, 5, policy_t> local{local_mesh, scene, porder, cfl, policy_t{2}};
+        tSolver_t serial_solver, local_solver;
+
+        for (size_t step = 0; step < 50; step++) {
+            scalar_t dt = serial.compute_dt_global();
+            serial_solver.advance(serial, dt);
+            local_solver.advance(local, dt);
+        }
+        if (local.time != serial.time) return 1;
+
+        const size_t stride = local.field.stride();
+        const size_t offset = local_mesh.cell_offset * stride;
+        for (size_t i = 0; i < local_mesh.Ncells * stride; i++) {
+            if (local.field.u[i] != serial.field.u[offset + i]) return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    mpi::Environment env(argc, argv);
+    mpi::Communicator comm;
+
+    if (test_partition<integrator::time::SSP_RK3>(false, comm)) {
+        std::cout << "Partitioned shock tube test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (test_partition<integrator::time::SSP_RK3>(true, comm)) {
+        std::cout << "Partitioned periodic test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (test_partition<integrator::time::BS3>(false, comm)) {
+        std::cout << "Partitioned adaptive test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (test_partition<integrator::time::SSP_RK3, integrator::flux::HLLC<model_t>>(false, comm)) {
+        std::cout << "Partitioned HLLC test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (test_partition<integrator::time::SSP_RK3, integrator::flux::Roe<model_t>>(true, comm)) {
+        std::cout << "Partitioned periodic Roe test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (test_boundary_policies<integrator::time::LS_RK4>(comm)) {
+        std::cout << "Partitioned boundary policy test failed on rank " << comm.rank() << "!" << std::endl;
+        return 1;
+    }
+
+    if (comm.rank() == 0) std::cout << "All tests passed!" << std::endl;
+
+    return 0;
+}
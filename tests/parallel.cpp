@@ -0,0 +1,228 @@
+#include <DG.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/parallel.hpp"
+#include "core/scheduler.hpp"
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/timeSolver.hpp"
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using fSolver = integrator::flux::LaxFriedrichs<model_t>;
+
+enum class Boundaries {
+    Periodic,       // periodic mesh
+    Neumann,
+    InflowWall      // time-dependent inflow on the left, wall on the right
+};
+
+scene::Scene<model_t> make_scene(mesh::Line &mesh, Boundaries kind) {
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        if (x[0] < 0.5)
+            return model_t::var_t{2.0, 50.0, 2.0e5};
+        else
+            return model_t::var_t{1.0, 50.0, 1.0e5};
+    };
+    if (kind == Boundaries::Periodic) return scene;
+
+    scene.boundary_conditions.resize(mesh.set_boundary());
+    if (kind == Boundaries::Neumann) {
+        scene.boundary_conditions[LEFT] = [] () {
+            return scene::Boundary<model_t>::Neumann();
+        };
+        scene.boundary_conditions[RIGHT] = [] () {
+            return scene::Boundary<model_t>::Neumann();
+        };
+    } else {
+        scene.boundary_conditions[LEFT] = [] () {
+            return scene::Boundary<model_t>::Inflow({0.0, 1e-4}, {model_t::PtoU({2.0, 50.0, 2.0e5}), model_t::PtoU({2.0, 100.0, 2.1e5})});
+        };
+        scene.boundary_conditions[RIGHT] = [] () {
+            return scene::Boundary<model_t>::Wall();
+        };
+    }
+    return scene;
+}
+
+/*
+    the thread pool must reproduce the serial run bit for bit: the dt of every step and the
+    state after it, with static chunks as well as with work stealing
+*/
+template<typename tSolver_t, typename fSolver_t = fSolver>
+bool test_policies(Boundaries kind, execution::parallel_policy policy) {
+    size_t porder = 4;
+    size_t mesh_size = 50;
+    scalar_t cfl = 0.5;
+
+    mesh::Line serial_mesh(mesh_size, 1.0), parallel_mesh(mesh_size, 1.0);
+    scene::Scene<model_t> serial_scene = make_scene(serial_mesh, kind);
+    scene::Scene<model_t> parallel_scene = make_scene(parallel_mesh, kind);
+
+    integrator::Integrator<model_t, fSolver_t, 5> serial{serial_mesh, serial_scene, porder, cfl};
+    integrator::Integrator<model_t, fSolver_t, 5, execution::parallel_policy> parallel{parallel_mesh, parallel_scene, porder, cfl, policy};
+    tSolver_t serial_solver, parallel_solver;
+
+    for (size_t step = 0; step < 50; step++) {
+        scalar_t dt = serial.compute_dt_global();
+        if (parallel.compute_dt_global() != dt) return 1;
+        serial_solver.advance(serial, dt);
+        parallel_solver.advance(parallel, dt);
+    }
+    if (parallel.time != serial.time) return 1;
+
+    for (size_t i = 0; i < serial.field.u.size(); i++) {
+        if (parallel.field.u[i] != serial.field.u[i]) return 1;
+    }
+
+    return 0;
+}
+
+/*
+    every index of a work-stealing loop runs exactly once, for skewed costs and for loops with
+    fewer items than threads; consecutive loops reuse the deques
+*/
+bool test_stealing() {
+    const size_t threads = 4;
+    execution::ThreadPool pool(threads);
+
+    for (size_t n : {0, 1, 3, 100, 1000, 4096}) {
+        // a few expensive items at the start, so the first block of tasks is heavy
+        std::vector<scalar_t> cost(n, 1.0);
+        for (size_t i = 0; i < std::min<size_t>(n, 16); i++) cost[i] = 1000.0;
+
+        std::vector<std::atomic<size_t>> count(n);
+        for (size_t repeat = 0; repeat < 5; repeat++) {
+            pool.run([&](size_t t) {
+                execution::Team team = pool.team(t, true);
+                team.for_each(n, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        // busy work proportional to the cost
+                        volatile scalar_t x = 0.0;
+                        for (size_t k = 0; k < cost[i]; k++) x = x + 1.0;
+                        count[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }, (repeat % 2) ? cost.data() : nullptr);
+            });
+            for (size_t i = 0; i < n; i++) {
+                if (count[i].load() != repeat + 1) return 1;
+            }
+        }
+    }
+
+    // the deque alone: every pushed id is popped or stolen once
+    execution::ChaseLevDeque deque(1024);
+    const size_t n = 1000;
+    std::vector<std::atomic<size_t>> count(n);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> thieves;
+    for (size_t t = 0; t < 3; t++) {
+        thieves.emplace_back([&] {
+            size_t x;
+            while (!done.load()) {
+                if (deque.steal(x)) count[x].fetch_add(1);
+            }
+        });
+    }
+    for (size_t i = 0; i < n; i++) deque.push(i);
+    size_t x;
+    while (deque.pop(x)) count[x].fetch_add(1);
+    done = true;
+    for (auto &t : thieves) t.join();
+    for (size_t i = 0; i < n; i++) {
+        if (count[i].load() != 1) return 1;
+    }
+
+    return 0;
+}
+
+/*
+    the measured costs are folded into the per-cell costs; the work-stealing integrator
+    measures every cell
+*/
+bool test_cost_model() {
+    execution::CostModel model(4);
+    model.record(0, 2, 2.0);
+    model.commit(0, 4);
+    if (model.cost[0] != 1.0 || model.cost[1] != 1.0 || model.cost[2] != 0.0 || model.cost[3] != 0.0) return 1;
+
+    // exponential moving average once a cell has a cost
+    model.record(0, 2, 4.0);
+    model.commit(0, 2);
+    if (model.cost[0] != 0.75 * 1.0 + 0.25 * 2.0 || model.cost[1] != model.cost[0]) return 1;
+
+    mesh::Line mesh(50, 1.0);
+    scene::Scene<model_t> scene = make_scene(mesh, Boundaries::Neumann);
+    integrator::Integrator<model_t, fSolver, 5, execution::parallel_policy> integrator{mesh, scene, 4, 0.5, execution::parallel_policy{3, true}};
+    for (scalar_t c : integrator.cost_model.cost) {
+        if (c != 0.0) return 1;
+    }
+    integrator::time::SSP_RK3 solver;
+    solver.advance(integrator, integrator.compute_dt_global());
+    for (scalar_t c : integrator.cost_model.cost) {
+        if (!(c > 0.0)) return 1;
+    }
+
+    return 0;
+}
+
+int main() {
+    if (test_stealing()) {
+        std::cout << "Work stealing test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_cost_model()) {
+        std::cout << "Cost model test failed!" << std::endl;
+        return 1;
+    }
+
+    // static chunks and work stealing
+    for (size_t threads : {2, 3, 4}) {
+        for (bool stealing : {false, true}) {
+            execution::parallel_policy policy{threads, stealing};
+            const std::string name = std::to_string(threads) + (stealing ? " stealing" : "") + " threads";
+
+            if (test_policies<integrator::time::RK2>(Boundaries::Neumann, policy)) {
+                std::cout << "RK2 test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+
+            if (test_policies<integrator::time::SSP_RK3>(Boundaries::Neumann, policy)) {
+                std::cout << "SSP_RK3 test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+
+            if (test_policies<integrator::time::LS_RK4>(Boundaries::Neumann, policy)) {
+                std::cout << "LS_RK4 test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+
+            if (test_policies<integrator::time::SSP_RK3>(Boundaries::Periodic, policy)) {
+                std::cout << "Periodic test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+
+            if (test_policies<integrator::time::RK2, integrator::flux::HLLC<model_t>>(Boundaries::InflowWall, policy)) {
+                std::cout << "HLLC boundary policy test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+
+            if (test_policies<integrator::time::SSP_RK3, integrator::flux::Roe<model_t>>(Boundaries::Periodic, policy)) {
+                std::cout << "Roe test failed with " << name << "!" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <DG.hpp>
+#include <cmath>
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/steadySolver.hpp"
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using fSolver = integrator::flux::LaxFriedrichs<model_t>;
+using integrator_t = integrator::Integrator<model_t, fSolver>;
+
+/*
+    cycles of the p-multigrid solver to the steady state of a supersonic flow with a density
+    and pressure bump, 0 if it did not converge. The residual history decreases to rtol: the
+    bump leaves through the outflow first, so single cycles may grow a little, but never over
+    `window` cycles.
+*/
+size_t cycles_to_converge(size_t levels) {
+    const size_t window = 20;
+
+    mesh::Line mesh(20, 1.0);
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        const scalar_t bump = std::exp(-100.0 * (x[0] - 0.5) * (x[0] - 0.5));
+        return model_t::var_t{1.0 + 0.2 * bump, 800.0, 1.0e5 * (1.0 + 0.2 * bump)};
+    };
+    scene.boundary_conditions.resize(mesh.set_boundary());
+    scene.boundary_conditions[LEFT] = [] () {
+        return scene::Boundary<model_t>::Dirichlet(model_t::PtoU({1.0, 800.0, 1.0e5}));
+    };
+    scene.boundary_conditions[RIGHT] = [] () {
+        return scene::Boundary<model_t>::Neumann();
+    };
+
+    integrator_t integrator{mesh, scene, 4, 0.5};
+    integrator::steady::PMultigrid<integrator_t> solver(integrator, mesh, levels);
+    solver.rtol = 1e-6;
+    solver.max_cycles = 1000;
+    if (solver.levels() != levels) return 0;
+
+    while (!solver.converged() && solver.history.size() < solver.max_cycles) {
+        solver.cycle(integrator);
+    }
+    if (!solver.converged()) return 0;
+
+    const auto &history = solver.history;
+    if (history.back() > solver.rtol * history.front()) return 0;
+    for (size_t k = 0; k < history.size(); k++) {
+        if (!std::isfinite(history[k]) || history[k] > history.front()) return 0;
+        if (k + window < history.size() && history[k + window] >= history[k]) return 0;
+    }
+
+    return history.size();
+}
+
+int main() {
+    // pseudo-time stepping of the finest level alone
+    const size_t single = cycles_to_converge(1);
+    if (!single) {
+        std::cout << "Single level test failed!" << std::endl;
+        return 1;
+    }
+
+    // the coarse levels remove the smooth error faster
+    for (size_t levels : {2, 4}) {
+        const size_t cycles = cycles_to_converge(levels);
+        std::cout << levels << " levels: " << cycles << " cycles, 1 level: " << single << " cycles" << std::endl;
+        if (!cycles || cycles >= single) {
+            std::cout << "P-multigrid test failed with " << levels << " levels!" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include <DG.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "scene/scene.hpp"
+#include "integrator/integrator.hpp"
+#include "integrator/fluxSolver.hpp"
+#include "integrator/timeSolver.hpp"
+#include "mesh/line.hpp"
+#include "model/euler.hpp"
+
+using namespace DG;
+
+using model_t = model::Euler<1>;
+using fSolver = integrator::flux::LaxFriedrichs<model_t>;
+using integrator_t = integrator::Integrator<model_t, fSolver>;
+
+// smooth density wave advected with the flow on a periodic domain
+scene::Scene<model_t> make_scene() {
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        return model_t::var_t{2.0 + std::sin(2.0 * M_PI * x[0]), 1.0, 1.0};
+    };
+    return scene;
+}
+
+/*
+    state at end_time after `steps` steps of the same size, on a fixed mesh so that only the
+    time discretization changes between runs
+*/
+template<typename tSolver_t>
+std::vector<scalar_t> solve(tSolver_t &solver, size_t steps, scalar_t end_time) {
+    mesh::Line mesh(10, 1.0);
+    scene::Scene<model_t> scene = make_scene();
+    integrator_t integrator{mesh, scene, 3, 0.5};
+    for (size_t step = 0; step < steps; step++) {
+        solver.advance(integrator, end_time / steps);
+    }
+    const auto &u = integrator.field.u;
+    return std::vector<scalar_t>(u.data(), u.data() + u.size());
+}
+
+scalar_t max_error(const std::vector<scalar_t> &u, const std::vector<scalar_t> &ref) {
+    scalar_t error = 0.0;
+    for (size_t i = 0; i < u.size(); i++) error = std::max(error, std::abs(u[i] - ref[i]));
+    return error;
+}
+
+/*
+    observed order of the time solver on three step sizes, against a run with much smaller
+    steps of the same spatial discretization
+*/
+template<typename tSolver_t>
+scalar_t observed_order(size_t steps, scalar_t end_time) {
+    tSolver_t solver;
+    const std::vector<scalar_t> ref = solve(solver, 32 * steps, end_time);
+
+    scalar_t order = 1e9;
+    scalar_t error_prev = 0.0;
+    for (size_t k = 0; k < 3; k++) {
+        tSolver_t s;
+        const scalar_t error = max_error(solve(s, (size_t(1) << k) * steps, end_time), ref);
+        if (k > 0) order = std::min(order, std::log2(error_prev / error));
+        error_prev = error;
+    }
+    return order;
+}
+
+/*
+    the low storage scheme is fourth order and only holds u and the residual register
+*/
+bool test_ls_rk4() {
+    const scalar_t order = observed_order<integrator::time::LS_RK4>(40, 0.1);
+    std::cout << "LS_RK4 order: " << order << std::endl;
+    if (order < 3.8) return 1;
+
+    mesh::Line mesh(10, 1.0);
+    scene::Scene<model_t> scene = make_scene();
+    integrator_t integrator{mesh, scene, 3, 0.5};
+    integrator::time::LS_RK4 solver;
+    solver.advance(integrator, integrator.compute_dt_global());
+    if (integrator.field.u0.size() || integrator.field.F.size() || !integrator.field.dudt.size()) return 1;
+
+    return 0;
+}
+
+/*
+    local time stepping on a periodic mesh with a hot region, so that the cells fall on several
+    levels: mass, momentum and energy are conserved to round-off in every macro step, and the
+    state converges to the one of small global steps at (at least) second order, the order of
+    the coupling between the levels
+*/
+bool test_lts() {
+    const scalar_t end_time = 0.01;
+    scene::Scene<model_t> scene;
+    scene.initial_condition = [] (const arr_t<1>& x) {
+        const scalar_t bump = std::exp(-std::pow((x[0] - 0.5) / 0.1, 2));
+        return model_t::var_t{1.0 + 0.2 * std::sin(2.0 * M_PI * x[0]), 0.5, 1.0 + 8.0 * bump};
+    };
+
+    // integral of every conserved variable over the domain
+    auto integrals = [] (const integrator_t &integrator) {
+        constexpr size_t NE = model_t::NumEqns;
+        const auto &field = integrator.field;
+        std::vector<scalar_t> sum(NE, 0.0);
+        for (size_t c = 0; c < field.Ncells; c++) {
+            for (size_t i = 0; i < field.Nnodes; i++) {
+                for (size_t k = 0; k < NE; k++) {
+                    sum[k] += field.detJ[c] * integrator.ref_cell.w[i] * field.u[(c * field.Nnodes + i) * NE + k];
+                }
+            }
+        }
+        return sum;
+    };
+
+    // global SSP_RK3 steps far below the CFL limit
+    mesh::Line ref_mesh(40, 1.0);
+    integrator_t reference{ref_mesh, scene, 3, 0.5};
+    integrator::time::SSP_RK3 ref_solver;
+    for (size_t step = 0; step < 1000; step++) ref_solver.advance(reference, end_time / 1000);
+    const std::vector<scalar_t> u_ref(reference.field.u.data(), reference.field.u.data() + reference.field.u.size());
+
+    std::vector<scalar_t> error;
+    for (scalar_t cfl : {0.4, 0.2}) {
+        mesh::Line mesh(40, 1.0);
+        integrator_t integrator{mesh, scene, 3, cfl};
+        integrator::time::LTS solver(4);
+        const std::vector<scalar_t> initial = integrals(integrator);
+
+        for (size_t step = 0; integrator.time < end_time * (1.0 - 1e-12); step++) {
+            const scalar_t dt_min = integrator.compute_dt_global();
+            const scalar_t dt = solver.step(integrator, end_time - integrator.time);
+            if (step == 0 && dt < 2.0 * dt_min) return 1;  // a single level
+
+            const std::vector<scalar_t> current = integrals(integrator);
+            for (size_t k = 0; k < initial.size(); k++) {
+                if (std::abs(current[k] - initial[k]) > 1e-14 * std::max<scalar_t>(1.0, std::abs(initial[k]))) return 1;
+            }
+        }
+
+        const std::vector<scalar_t> u(integrator.field.u.data(), integrator.field.u.data() + integrator.field.u.size());
+        error.push_back(max_error(u, u_ref));
+    }
+
+    const scalar_t order = std::log2(error[0] / error[1]);
+    std::cout << "LTS order: " << order << std::endl;
+    if (order < 1.8) return 1;
+
+    return 0;
+}
+
+/*
+    BDF2 far above the explicit limit on the smooth wave: every Newton solve converges and the
+    error against small LS_RK4 steps is second order in dt, with and without the assembled
+    Jacobian as preconditioner of GMRES
+*/
+bool test_bdf2(integrator::time::BDF2::Jacobian jacobian) {
+    const scalar_t end_time = 0.4;
+
+    integrator::time::LS_RK4 ref_solver;
+    const std::vector<scalar_t> ref = solve(ref_solver, 800, end_time);
+
+    std::vector<scalar_t> error;
+    for (size_t steps : {8, 16, 32}) {
+        mesh::Line mesh(10, 1.0);
+        scene::Scene<model_t> scene = make_scene();
+        integrator_t integrator{mesh, scene, 3, 0.5};
+        if (steps == 8 && end_time / steps < 5.0 * integrator.compute_dt_global()) return 1;   // not a large step
+
+        integrator::time::BDF2 solver;
+        solver.jacobian = jacobian;
+        for (size_t step = 0; step < steps; step++) {
+            if (!solver.advance(integrator, end_time / steps)) return 1;
+        }
+        if (solver.newton.failures || solver.rejected) return 1;
+
+        const std::vector<scalar_t> u(integrator.field.u.data(), integrator.field.u.data() + integrator.field.u.size());
+        error.push_back(max_error(u, ref));
+    }
+
+    // the largest step is not yet in the asymptotic range
+    const scalar_t order = std::log2(error[1] / error[2]);
+    std::cout << "BDF2 order: " << order << std::endl;
+    if (error[0] < error[1] || order < 1.8) return 1;
+
+    return 0;
+}
+
+/*
+    a step whose Newton iteration does not converge is rejected with u and the time restored;
+    `step` halves it until Newton converges, or returns 0
+*/
+bool test_bdf2_rejection() {
+    mesh::Line mesh(10, 1.0);
+    scene::Scene<model_t> scene = make_scene();
+    integrator_t integrator{mesh, scene, 3, 0.5};
+    const std::vector<scalar_t> initial(integrator.field.u.data(), integrator.field.u.data() + integrator.field.u.size());
+
+    integrator::time::BDF2 solver;
+    solver.newton.newton_rtol = 1e-10;
+    solver.newton.newton_atol = 0.0;
+    solver.newton.max_newton_iterations = 1;
+    if (solver.step(integrator, 0.05) != 0.0 || solver.rejected != solver.max_rejections + 1) return 1;
+    if (integrator.time != 0.0) return 1;
+    for (size_t i = 0; i < initial.size(); i++) {
+        if (integrator.field.u[i] != initial[i]) return 1;
+    }
+
+    // converges once the step is small enough
+    solver.newton.max_newton_iterations = 3;
+    const scalar_t dt = solver.step(integrator, 0.05);
+    if (!(dt > 0.0 && dt < 0.05) || integrator.time != dt) return 1;
+
+    return 0;
+}
+
+int main() {
+    if (test_ls_rk4()) {
+        std::cout << "LS_RK4 test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_lts()) {
+        std::cout << "LTS test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_bdf2(integrator::time::BDF2::Jacobian::Free)) {
+        std::cout << "BDF2 Jacobian-free test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_bdf2(integrator::time::BDF2::Jacobian::Preconditioned)) {
+        std::cout << "BDF2 preconditioned test failed!" << std::endl;
+        return 1;
+    }
+
+    if (test_bdf2_rejection()) {
+        std::cout << "BDF2 rejection test failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+
+    return 0;
+}